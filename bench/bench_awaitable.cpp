@@ -0,0 +1,147 @@
+// Callback awaitable benchmark (C++20); prints CSV of nanoseconds and heap
+// allocations per round trip of a callback-style async operation whose
+// callback runs inline ("now") or later from an event loop ("later"):
+// awaited by awaitable_from in one running coroutine, in a coroutine per
+// operation with its frame from the heap or from a frame_arena, and
+// waited for through a std::promise, set by the callback, and its future.
+// Usage: bench_awaitable [operations]  (default 1<<20)
+#include <chrono>
+#include <coroutine>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <new>
+#include "function_adaptors.hpp"
+
+std::size_t allocations = 0;
+
+void* operator new(std::size_t n)
+{
+  ++allocations;
+  if (void* p = std::malloc(n ? n : 1))
+    return p;
+  throw std::bad_alloc{};
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+using Sum = ltl::inline_function<void(int) noexcept, 4 * sizeof(void*)>;
+
+// pending, value the event loop's one pending callback and its result
+Sum pending;
+int value;
+
+void async_now(int a, int b, Sum cb) { cb(a + b); }
+void async_later(int a, int b, Sum cb)
+{
+  value = a + b;
+  pending = std::move(cb);
+}
+
+// drain() runs pending callbacks, each of which may leave another
+void drain()
+{
+  while (pending) {
+    Sum cb = std::move(pending);
+    pending = Sum{};
+    cb(value);
+  }
+}
+
+using Arena = ltl::frame_arena<1024>;
+
+template <class Base>
+struct task
+{
+  struct promise_type : Base
+  {
+    task get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::abort(); }
+  };
+};
+struct heap {};
+
+long sum = 0;
+
+template <auto op>
+task<heap> many(std::size_t n)
+{
+  for (std::size_t i = 0; i != n; ++i)
+    sum += co_await ltl::awaitable_from<op>(int(i & 7), 1);
+}
+
+template <auto op>
+task<heap> one(int i)
+{
+  sum += co_await ltl::awaitable_from<op>(i, 1);
+}
+
+template <auto op>
+task<ltl::arena_frames<Arena>> one_in(Arena&, int i)
+{
+  sum += co_await ltl::awaitable_from<op>(i, 1);
+}
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t operations = 1 << 20;
+
+template <class Run>
+void measure(char const* mechanism, char const* completion, Run run)
+{
+  std::size_t a0 = allocations;
+  auto t0 = clock_type::now();
+  run();
+  auto t1 = clock_type::now();
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%s,%.3f,%.3f\n", mechanism, completion,
+              ns / double(operations),
+              double(allocations - a0) / double(operations));
+}
+
+template <auto op>
+void rows(char const* completion)
+{
+  measure("awaitable_from_running", completion, [] {
+    many<op>(operations);
+    drain();
+  });
+  measure("awaitable_from_heap_frame", completion, [] {
+    for (std::size_t i = 0; i != operations; ++i) {
+      one<op>(int(i & 7));
+      drain();
+    }
+  });
+  Arena arena;
+  measure("awaitable_from_arena_frame", completion, [&] {
+    for (std::size_t i = 0; i != operations; ++i) {
+      one_in<op>(arena, int(i & 7));
+      drain();
+    }
+  });
+  measure("promise_future", completion, [] {
+    for (std::size_t i = 0; i != operations; ++i) {
+      std::promise<int> p;
+      std::future<int> f = p.get_future();
+      op(int(i & 7), 1, Sum{[p = std::move(p)](int r) mutable noexcept {
+        p.set_value(r);
+      }});
+      drain();
+      sum += f.get();
+    }
+  });
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    operations = std::strtoul(argv[1], nullptr, 10);
+
+  std::printf("mechanism,completion,ns_per_op,allocations_per_op\n");
+  rows<&async_now>("now");
+  rows<&async_later>("later");
+  std::printf("\nsum,%ld\n", sum);
+}
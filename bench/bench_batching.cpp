@@ -0,0 +1,89 @@
+// Call batching benchmark; prints CSV of millions of items per second
+// delivered to a sink by a direct call per item and by batching<F> with
+// batches of 16, 64 and 256 items, for a sink that just sums its items
+// and for one that takes a lock per call (per item, or per batch).
+// Usage: bench_batching [items]  (default 1<<24 items)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include "function_adaptors.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t items = 1 << 24;
+std::mutex lock;
+double total;
+
+NOINLINE void item(int id, double v) noexcept { total += id * v; }
+
+NOINLINE void locked_item(int id, double v) noexcept
+{
+  std::lock_guard<std::mutex> guard{lock};
+  total += id * v;
+}
+
+struct Sum
+{
+  NOINLINE void operator()(std::size_t n, int* id, double* v) noexcept
+  {
+    for (std::size_t i = 0; i != n; ++i)
+      total += id[i] * v[i];
+  }
+};
+
+struct LockedSum
+{
+  NOINLINE void operator()(std::size_t n, int* id, double* v) noexcept
+  {
+    std::lock_guard<std::mutex> guard{lock};
+    for (std::size_t i = 0; i != n; ++i)
+      total += id[i] * v[i];
+  }
+};
+
+template <class Call>
+void measure(char const* sink, char const* mechanism, std::size_t batch,
+             Call&& call)
+{
+  auto t0 = clock_type::now();
+  for (std::size_t i = 0; i != items; ++i)
+    call(int(i & 255), 0.5);
+  auto t1 = clock_type::now();
+  double s = std::chrono::duration<double>(t1 - t0).count();
+  std::printf("%s,%s,%zu,%.1f\n", sink, mechanism, batch,
+              double(items) / s / 1e6);
+}
+
+template <class BatchF, std::size_t N>
+void batched(char const* sink)
+{
+  ltl::batching<void(int, double) noexcept, BatchF, N> b;
+  measure(sink, "batching", N, b);
+  b.flush();
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    items = std::strtoul(argv[1], nullptr, 10);
+
+  std::printf("sink,mechanism,batch,million_items_per_s\n");
+  measure("sum", "direct", 1, item);
+  batched<Sum, 16>("sum");
+  batched<Sum, 64>("sum");
+  batched<Sum, 256>("sum");
+  measure("locked_sum", "direct", 1, locked_item);
+  batched<LockedSum, 16>("locked_sum");
+  batched<LockedSum, 64>("locked_sum");
+  batched<LockedSum, 256>("locked_sum");
+  std::printf("\ntotal,%.0f\n", total);
+}
@@ -0,0 +1,105 @@
+// Message bus benchmark; prints CSV of nanoseconds per lookup and call of
+// a handler among HANDLERS, each for its own message type Msg<I>, by
+// bus<int(Msg<I>&) noexcept...>::call at call sites that name the type,
+// and by std::unordered_map<std::string, std::function<int(void*)>>::find
+// of the handler's name, at HANDLERS and at 10000 handlers for the map.
+// bus keys are types: each handler needs its own signature, so N handlers
+// are N message types, and the bus instantiates one slot base class each;
+// a bus of 10000 is not built, see the Message bus notes in the header.
+// Usage: bench_bus [passes]  (default 1<<20 lookups per row)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "function_adaptors.hpp"
+
+#ifndef HANDLERS
+#   define HANDLERS 100
+#endif
+
+template <std::size_t I> struct Msg { int v; };
+
+template <std::size_t I> int handle(Msg<I>& m) noexcept
+{
+  return m.v * int(I % 7 + 1);
+}
+
+// msg<I> the message of type I passed to its handler
+template <std::size_t I> Msg<I> msg{3};
+
+template <class> struct handlers;
+template <std::size_t... I>
+struct handlers<std::index_sequence<I...>>
+{
+  using bus = ltl::bus<int(Msg<I>&) noexcept...>;
+
+  static void on(bus& b) { (b.template on<&handle<I>>(), ...); }
+
+  // pass(b) calls each handler once, each at its own call site
+  static int pass(bus const& b)
+  {
+    return (b.template call<int(Msg<I>&) noexcept>(msg<I>) + ...);
+  }
+};
+using each = handlers<std::make_index_sequence<HANDLERS>>;
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t lookups = 1 << 20;
+volatile int sink;
+
+template <class Pass>
+void measure(char const* mechanism, std::size_t handlers, Pass pass)
+{
+  int sum = 0;
+  std::size_t n = 0;
+  auto t0 = clock_type::now();
+  while (n < lookups)
+    sum += pass(n);
+  auto t1 = clock_type::now();
+  sink = sum;
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%zu,%.3f,%.1f\n", mechanism, handlers, ns / double(n),
+              double(n) / ns * 1e3);
+}
+
+void map(std::size_t handlers)
+{
+  std::unordered_map<std::string, std::function<int(void*)>> m;
+  std::vector<std::string> names;
+  for (std::size_t i = 0; i != handlers; ++i) {
+    names.push_back("message_" + std::to_string(i));
+    m.emplace(names.back(), [k = int(i % 7 + 1)](void* p) {
+      return static_cast<Msg<0>*>(p)->v * k;
+    });
+  }
+  Msg<0> m0{3};
+  measure("unordered_map_std_function", handlers, [&](std::size_t& n) {
+    int sum = 0;
+    for (auto const& name : names)
+      sum += m.find(name)->second(&m0);
+    n += names.size();
+    return sum;
+  });
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    lookups = std::strtoul(argv[1], nullptr, 10);
+
+  std::printf("mechanism,handlers,ns_per_lookup,million_lookups_per_s\n");
+  each::bus b;
+  each::on(b);
+  measure("bus", HANDLERS, [&](std::size_t& n) {
+    n += HANDLERS;
+    return each::pass(b);
+  });
+  map(HANDLERS);
+  if (HANDLERS != 10000)
+    map(10000);
+}
@@ -0,0 +1,76 @@
+// C callback benchmark; prints CSV of nanoseconds per callback through a
+// C style API taking R(*)(void*, P...) and a void* user data pointer, for
+// c_thunk<&C::f> and c_thunk_for<L> with the object as user data, for a
+// hand written trampoline, and for a std::function held in user data
+// behind one generic trampoline.
+// Usage: bench_c_thunk [calls]  (default 1<<22 calls)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include "function_adaptors.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+struct Acc
+{
+  int n = 0;
+  int add(int k) noexcept { return n += k; }
+};
+
+using callback = int (*)(void*, int);
+
+// each(cb, user, calls) the C API, calling cb(user, i & 7) calls times
+NOINLINE int each(callback cb, void* user, std::size_t calls)
+{
+  int sum = 0;
+  for (std::size_t i = 0; i != calls; ++i)
+    sum += cb(user, int(i & 7));
+  return sum;
+}
+
+int trampoline(void* user, int k)
+{
+  return static_cast<Acc*>(user)->add(k);
+}
+
+int std_function_trampoline(void* user, int k)
+{
+  return (*static_cast<std::function<int(int)>*>(user))(k);
+}
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t calls = 1 << 22;
+volatile int sink;
+
+void measure(char const* mechanism, callback cb, void* user)
+{
+  auto t0 = clock_type::now();
+  sink = each(cb, user, calls);
+  auto t1 = clock_type::now();
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%.3f\n", mechanism, ns / double(calls));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    calls = std::strtoul(argv[1], nullptr, 10);
+
+  Acc acc;
+  auto lambda = [&acc](int k) noexcept { return acc.add(k); };
+  std::function<int(int)> fn = [&acc](int k) { return acc.add(k); };
+
+  std::printf("mechanism,ns_per_call\n");
+  measure("c_thunk", ltl::c_thunk<&Acc::add>, &acc);
+  measure("c_thunk_for_lambda", ltl::c_thunk_for<decltype(lambda)>, &lambda);
+  measure("hand_trampoline", trampoline, &acc);
+  measure("std_function_user_data", std_function_trampoline, &fn);
+}
@@ -0,0 +1,190 @@
+// Call dispatch microbenchmark; prints CSV of nanoseconds per call for
+// each way of calling a signature, under predictable and unpredictable
+// targets. Usage: bench_call_dispatch [calls]  (default 1<<20 calls)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "function_traits.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+// TARGET_SET(N, NX, CV, REF, params...) four distinct target functions
+// N0..N3 of type int(params...) CV REF noexcept(NX)
+#define TARGET(NAME, NX, CV, REF, OP, ...)                                  \
+  NOINLINE int NAME(__VA_ARGS__) CV REF noexcept(NX) { return x OP; }
+#define TARGET_SET(N, NX, CV, REF, ...)                                     \
+  TARGET(N##0, NX, CV, REF, + 1, __VA_ARGS__)                               \
+  TARGET(N##1, NX, CV, REF, + 2, __VA_ARGS__)                               \
+  TARGET(N##2, NX, CV, REF, ^ 3, __VA_ARGS__)                               \
+  TARGET(N##3, NX, CV, REF, - 4, __VA_ARGS__)
+
+// QUALIFIERS(X) the 12 cvref qualifier combinations X(name, cv, ref)
+#define QUALIFIERS(X)                                                       \
+  X(Q0, , ) X(Q1, const, ) X(Q2, volatile, ) X(Q3, const volatile, )        \
+  X(Q4, , &) X(Q5, const, &) X(Q6, volatile, &) X(Q7, const volatile, &)    \
+  X(Q8, , &&) X(Q9, const, &&) X(Q10, volatile, &&)                         \
+  X(Q11, const volatile, &&)
+
+// Each class has targets f, g, v, w for (noexcept, varargs) combinations
+// and is pointer sized, as a member pointer call may read a vtable pointer
+#define MEMBERS(NAME, CV, REF)                                              \
+struct NAME                                                                 \
+{                                                                           \
+  void* vptr_sized = nullptr;                                               \
+  TARGET_SET(f, false, CV, REF, int x)                                      \
+  TARGET_SET(g, true, CV, REF, int x)                                       \
+  TARGET_SET(v, false, CV, REF, int x, ...)                                 \
+  TARGET_SET(w, true, CV, REF, int x, ...)                                  \
+};
+QUALIFIERS(MEMBERS)
+#undef MEMBERS
+
+namespace fn
+{
+TARGET_SET(f, false, , , int x)
+TARGET_SET(g, true, , , int x)
+TARGET_SET(v, false, , , int x, ...)
+TARGET_SET(w, true, , , int x, ...)
+} // namespace fn
+
+struct Base { virtual int call(int x) = 0; virtual ~Base() = default; };
+template <int I> struct Derived : Base
+{
+  NOINLINE int call(int x) override { return x + I; }
+};
+
+// signature<F>() the name of function type F, from its function_traits
+template <typename F>
+std::string signature()
+{
+  using namespace ltl;
+  std::string s = function_is_variadic_v<F> ? "int(int, ...)" : "int(int)";
+  if (function_is_const_v<F>) s += " const";
+  if (function_is_volatile_v<F>) s += " volatile";
+  if (function_is_reference_lvalue_v<F>) s += " &";
+  if (function_is_reference_rvalue_v<F>) s += " &&";
+  if (function_is_noexcept_v<F>) s += " noexcept";
+  return s;
+}
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t calls = 1 << 20;
+std::vector<unsigned> same, mixed;  // target index per call
+volatile int sink;
+
+// measure(mechanism, signature, call) prints the CSV rows for call(i, x),
+// calling target i with argument x, as independent calls (throughput)
+// and as a chain of dependent calls (latency)
+template <class Call>
+void measure(char const* mechanism, std::string const& sig, Call call)
+{
+  for (auto* picks : {&same, &mixed})
+  {
+    auto const* p = picks->data();
+    auto t0 = clock_type::now();
+    int sum = 0;
+    for (std::size_t i = 0; i != calls; ++i)
+      sum += call(p[i], int(i));
+    auto t1 = clock_type::now();
+    int x = 0;
+    for (std::size_t i = 0; i != calls; ++i)
+      x = call(p[i], x);
+    auto t2 = clock_type::now();
+    sink = sum + x;
+
+    auto ns = [](auto d) {
+      return std::chrono::duration<double, std::nano>(d).count() / calls;
+    };
+    std::printf("%s,%s,%s,%.3f,%.3f\n", mechanism, sig.c_str(),
+                picks == &same ? "predictable" : "unpredictable",
+                ns(t1 - t0), ns(t2 - t1));
+  }
+}
+
+template <typename F>
+void pointers(F* f0, F* f1, F* f2, F* f3)
+{
+  F* table[] = {f0, f1, f2, f3};
+  measure("function_pointer", signature<F>(),
+          [&](unsigned i, int x) { return table[i](x); });
+}
+
+// members: the object is an rvalue for && qualified F, else an lvalue
+template <class C, typename F>
+void members(F C::* f0, F C::* f1, F C::* f2, F C::* f3)
+{
+  F C::* table[] = {f0, f1, f2, f3};
+  measure("member_pointer", signature<F>(), [&](unsigned i, int x) {
+    C c;
+    if constexpr (ltl::function_is_reference_rvalue_v<F>)
+      return (std::move(c).*table[i])(x);
+    else
+      return (c.*table[i])(x);
+  });
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    calls = std::strtoul(argv[1], nullptr, 10);
+  std::mt19937 rng{42};
+  same.assign(calls, 0);
+  for (std::size_t i = 0; i != calls; ++i)
+    mixed.push_back(rng() % 4);
+
+  std::printf("mechanism,signature,targets,throughput_ns,latency_ns\n");
+
+  measure("direct", signature<int(int)>(), [](unsigned i, int x) {
+    switch (i) {
+      case 0: return fn::f0(x);
+      case 1: return fn::f1(x);
+      case 2: return fn::f2(x);
+      default: return fn::f3(x);
+    }
+  });
+
+  // a generic lambda dispatching to the same targets as the direct row
+  auto dispatch = [](unsigned i, auto x) {
+    switch (i) {
+      case 0: return fn::f0(x);
+      case 1: return fn::f1(x);
+      case 2: return fn::f2(x);
+      default: return fn::f3(x);
+    }
+  };
+  measure("lambda_template", signature<int(int)>(), dispatch);
+
+  pointers(fn::f0, fn::f1, fn::f2, fn::f3);
+  pointers(fn::g0, fn::g1, fn::g2, fn::g3);
+  pointers(fn::v0, fn::v1, fn::v2, fn::v3);
+  pointers(fn::w0, fn::w1, fn::w2, fn::w3);
+
+#define MEMBERS(NAME, CV, REF)                                              \
+  members(&NAME::f0, &NAME::f1, &NAME::f2, &NAME::f3);                      \
+  members(&NAME::g0, &NAME::g1, &NAME::g2, &NAME::g3);                      \
+  members(&NAME::v0, &NAME::v1, &NAME::v2, &NAME::v3);                      \
+  members(&NAME::w0, &NAME::w1, &NAME::w2, &NAME::w3);
+  QUALIFIERS(MEMBERS)
+#undef MEMBERS
+
+  Derived<1> d1; Derived<2> d2; Derived<3> d3; Derived<4> d4;
+  Base* objects[] = {&d1, &d2, &d3, &d4};
+  measure("virtual", signature<int(int)>(),
+          [&](unsigned i, int x) { return objects[i]->call(x); });
+
+  std::function<int(int)> functions[] = {fn::f0, fn::f1,
+                                         fn::f2, fn::f3};
+  measure("std_function", signature<int(int)>(),
+          [&](unsigned i, int x) { return functions[i](x); });
+}
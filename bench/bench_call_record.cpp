@@ -0,0 +1,81 @@
+// Call recording benchmark; prints CSV of nanoseconds per call recorded by
+// call_recorder, for several buffer sizes, against an unrecorded call, and
+// per call replayed by call_replayer at full speed.
+// Usage: bench_call_record [calls]  (default 1<<20 calls)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "function_adaptors.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+// A call of type Order is recorded; order() is the function it calls
+using Order = void(int id, double price, long quantity, char side);
+
+long total;
+NOINLINE void order(int id, double price, long quantity, char side) noexcept
+{
+  total += id + long(price) * quantity + side;
+}
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t calls = 1 << 20;
+
+void row(char const* phase, std::size_t buffer, clock_type::duration d)
+{
+  double ns = std::chrono::duration<double, std::nano>(d).count();
+  std::printf("%s,%zu,%zu,%.3f\n", phase, buffer, calls, ns / double(calls));
+}
+
+// record<N>(log) records calls with an N record buffer, then the calls
+template <std::size_t N>
+void record(std::FILE* log)
+{
+  std::rewind(log);
+  ltl::call_recorder<Order, N>::write_header(log);
+  auto t0 = clock_type::now();
+  {
+    ltl::call_recorder<Order, N> rec{log};
+    for (std::size_t i = 0; i != calls; ++i) {
+      rec(int(i), 1.5, long(i & 7), 'b');
+      order(int(i), 1.5, long(i & 7), 'b');
+    }
+  }
+  auto t1 = clock_type::now();
+  row("record", N, t1 - t0);
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    calls = std::strtoul(argv[1], nullptr, 10);
+  std::FILE* log = std::tmpfile();
+  if (!log)
+    return 1;
+
+  std::printf("phase,buffer,calls,ns_per_call\n");
+
+  auto t0 = clock_type::now();
+  for (std::size_t i = 0; i != calls; ++i)
+    order(int(i), 1.5, long(i & 7), 'b');
+  row("unrecorded", 0, clock_type::now() - t0);
+
+  record<16>(log);
+  record<256>(log);
+  record<4096>(log);
+
+  std::rewind(log);
+  ltl::call_replayer<Order> replay{log};
+  t0 = clock_type::now();
+  std::size_t n = replay.replay(order);
+  row(n == calls ? "replay" : "replay_short", 0, clock_type::now() - t0);
+  std::fclose(log);
+  return total == 0;
+}
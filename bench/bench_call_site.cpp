@@ -0,0 +1,89 @@
+// Call site caching microbenchmark; prints CSV of nanoseconds per call of
+// a type-erased inline_function and of a cached_call_site knowing two of
+// the target types, over mono-, bi- and megamorphic target type mixes.
+// Usage: bench_call_site [calls]  (default 1<<20 calls)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "function_adaptors.hpp"
+
+// Op<I> target type I; a small stateful callable
+template <int I> struct Op
+{
+  int k = I;
+  int operator()(int x) const noexcept { return (x ^ k) + I; }
+};
+
+using F = int(int) noexcept;
+using erased = ltl::inline_function<F>;
+using cached = ltl::cached_call_site<F, Op<0>, Op<1>>;
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t calls = 1 << 20;
+constexpr std::size_t sites = 1024;  // call site objects, visited in turn
+volatile int sink;
+
+// make<Site>(types) call site objects with target types in [0, types)
+template <class Site>
+std::vector<Site> make(unsigned types)
+{
+  std::mt19937 rng{42};
+  std::vector<Site> v;
+  for (std::size_t i = 0; i != sites; ++i)
+    switch (rng() % types) {
+      case 0: v.emplace_back(Op<0>{}); break;
+      case 1: v.emplace_back(Op<1>{}); break;
+      case 2: v.emplace_back(Op<2>{}); break;
+      default: v.emplace_back(Op<3>{}); break;
+    }
+  return v;
+}
+
+// measure(mechanism, workload, v) prints the CSV row for calling v's
+// sites in turn, as independent calls (throughput) and as a chain of
+// dependent calls (latency), with the cache hit rate if v's are cached
+template <class Site>
+void measure(char const* mechanism, char const* workload, std::vector<Site> v)
+{
+  auto t0 = clock_type::now();
+  int sum = 0;
+  for (std::size_t i = 0; i != calls; ++i)
+    sum += v[i % sites](int(i));
+  auto t1 = clock_type::now();
+  int x = 0;
+  for (std::size_t i = 0; i != calls; ++i)
+    x = v[i % sites](x);
+  auto t2 = clock_type::now();
+  sink = sum + x;
+
+  double rate = 0;
+  if constexpr (std::is_same_v<Site, cached>) {
+    std::size_t hits = 0;
+    for (auto& s : v)
+      hits += s.hits();
+    rate = double(hits) / double(2 * calls);
+  }
+  auto ns = [](auto d) {
+    return std::chrono::duration<double, std::nano>(d).count() / calls;
+  };
+  std::printf("%s,%s,%.3f,%.3f,%.3f\n", mechanism, workload,
+              ns(t1 - t0), ns(t2 - t1), rate);
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    calls = std::strtoul(argv[1], nullptr, 10);
+
+  std::printf("mechanism,workload,throughput_ns,latency_ns,hit_rate\n");
+
+  struct { char const* name; unsigned types; } const workloads[] = {
+    {"monomorphic", 1}, {"bimorphic", 2}, {"megamorphic", 4}};
+  for (auto w : workloads) {
+    measure("inline_function", w.name, make<erased>(w.types));
+    measure("cached_call_site", w.name, make<cached>(w.types));
+  }
+}
@@ -0,0 +1,95 @@
+// Signature conversion benchmark; prints CSV of nanoseconds per callback
+// of a registry of void(*)(int) slots filled with 16 noexcept handlers,
+// and 16 handlers returning long, by a thunk for every handler, as an
+// adaptor layer inserts them, and by function_convert, which stores a
+// noexcept handler's own pointer and thunks only the others, with the
+// number of thunks in each registry; also for the 16 noexcept handlers
+// alone, which function_convert stores with no thunk at all.
+// Usage: bench_convert [passes]  (default 1<<18 passes over 32 slots)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "function_adaptors.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+using Callback = void(int);
+
+long ticks = 0;
+
+template <int I> NOINLINE void on_event(int n) noexcept { ticks += n + I; }
+template <int I> NOINLINE long on_count(int n) { return ticks += n - I; }
+
+// thunk<f> the adaptor thunk stored for f whatever its type
+template <auto f> void thunk(int n) { f(n); }
+
+template <int... I>
+std::vector<Callback*> thunked(std::integer_sequence<int, I...>)
+{
+  return {&thunk<&on_event<I>>..., &thunk<&on_count<I>>...};
+}
+
+template <int... I>
+std::vector<Callback*> converted(std::integer_sequence<int, I...>)
+{
+  return {ltl::function_convert<Callback, &on_event<I>>...,
+          ltl::function_convert<Callback, &on_count<I>>...};
+}
+
+template <int... I>
+std::size_t thunks(std::vector<Callback*> const& r,
+                   std::integer_sequence<int, I...>)
+{
+  Callback* handlers[] = {&on_event<I>...};
+  std::size_t n = 0;
+  for (std::size_t k = 0; k != r.size(); ++k)
+    n += k >= sizeof...(I) || r[k] != handlers[k];
+  return n;
+}
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t passes = 1 << 18;
+
+void measure(char const* registry, char const* handlers,
+             std::vector<Callback*> const& r, std::size_t thunks)
+{
+  auto t0 = clock_type::now();
+  for (std::size_t p = 0; p != passes; ++p)
+    for (Callback* cb : r)
+      cb(int(p & 7));
+  auto t1 = clock_type::now();
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%s,%zu,%zu,%.3f\n", registry, handlers, r.size(), thunks,
+              ns / double(passes * r.size()));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    passes = std::strtoul(argv[1], nullptr, 10);
+
+  auto const each = std::make_integer_sequence<int, 16>{};
+  auto all = thunked(each);
+  auto direct = converted(each);
+
+  std::vector<Callback*> all_noexcept(all.begin(), all.begin() + 16);
+  std::vector<Callback*> direct_noexcept(direct.begin(), direct.begin() + 16);
+
+  std::printf("registry,handlers,slots,thunks,ns_per_callback\n");
+  measure("thunk_every_handler", "noexcept", all_noexcept,
+          thunks(all_noexcept, each));
+  measure("function_convert", "noexcept", direct_noexcept,
+          thunks(direct_noexcept, each));
+  measure("thunk_every_handler", "mixed", all, thunks(all, each));
+  measure("function_convert", "mixed", direct, thunks(direct, each));
+  std::printf("\nticks,%ld\n", ticks);
+}
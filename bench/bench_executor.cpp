@@ -0,0 +1,170 @@
+// Executor benchmark; prints CSV of nanoseconds per task for fan-out and
+// fork/join workloads on ltl::executor and on a baseline pool wrapping
+// each task in a std::packaged_task, for 1, 2, 4, ... threads up to the
+// core count, and for std::async fan-out.
+// Usage: bench_executor [tasks]  (default 1<<16 tasks)
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "function_adaptors.hpp"
+
+// Pool the usual baseline; one locked queue of std::function wrapping a
+// shared std::packaged_task, whose future every submit returns
+class Pool
+{
+  std::mutex m;
+  std::condition_variable cv;
+  std::queue<std::function<void()>> tasks;
+  std::vector<std::thread> threads;
+  bool stopping = false;
+
+ public:
+  explicit Pool(unsigned n)
+  {
+    for (unsigned i = 0; i != n; ++i)
+      threads.emplace_back([this] {
+        for (;;) {
+          std::unique_lock<std::mutex> lock{m};
+          cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+          if (tasks.empty())
+            return;
+          auto t = std::move(tasks.front());
+          tasks.pop();
+          lock.unlock();
+          t();
+        }
+      });
+  }
+  ~Pool()
+  {
+    {
+      std::lock_guard<std::mutex> lock{m};
+      stopping = true;
+    }
+    cv.notify_all();
+    for (auto& t : threads)
+      t.join();
+  }
+
+  template <class F>
+  auto submit(F f)
+  {
+    using R = decltype(f());
+    auto t = std::make_shared<std::packaged_task<R()>>(std::move(f));
+    auto result = t->get_future();
+    {
+      std::lock_guard<std::mutex> lock{m};
+      tasks.emplace([t] { (*t)(); });
+    }
+    cv.notify_one();
+    return result;
+  }
+};
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t tasks = 1 << 16;
+std::atomic<long> sink;
+
+// work() a small unit of task work
+void work() noexcept
+{
+  long x = 0;
+  for (int i = 0; i != 64; ++i)
+    x += i * i;
+  sink += x;
+}
+
+template <class Run>
+void measure(char const* mechanism, char const* workload, unsigned threads,
+             std::size_t n, Run run)
+{
+  auto t0 = clock_type::now();
+  run();
+  auto t1 = clock_type::now();
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%s,%u,%zu,%.3f\n", mechanism, workload, threads, n,
+              ns / double(n));
+}
+
+// fork(s, depth, left) forks a binary tree of 2^(depth+1) - 1 tasks,
+// each doing work(); the caller joins on the count of tasks left
+template <class Submit>
+void fork(Submit& s, int depth, std::atomic<std::size_t>& left) noexcept
+{
+  if (depth != 0)
+    for (int i = 0; i != 2; ++i)
+      s([&s, depth, &left]() noexcept { fork(s, depth - 1, left); });
+  work();
+  --left;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    tasks = std::strtoul(argv[1], nullptr, 10);
+  int depth = 0;
+  while ((std::size_t{2} << (depth + 1)) - 1 <= tasks)
+    ++depth;
+  std::size_t tree = (std::size_t{2} << depth) - 1;
+
+  std::printf("mechanism,workload,threads,tasks,ns_per_task\n");
+
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned n = 1;; n = std::min(2 * n, cores))
+  {
+    {
+      ltl::executor ex{n};
+      measure("executor", "fan_out", n, tasks, [&] {
+        for (std::size_t i = 0; i != tasks; ++i)
+          ex.submit(work);
+        ex.wait();
+      });
+      auto submit = [&ex](auto f) { ex.submit(std::move(f)); };
+      std::atomic<std::size_t> left{tree};
+      measure("executor", "fork_join", n, tree, [&] {
+        submit([&]() noexcept { fork(submit, depth, left); });
+        ex.wait_until([&] { return left.load() == 0; });
+      });
+    }
+    {
+      Pool pool{n};
+      measure("packaged_task_pool", "fan_out", n, tasks, [&] {
+        std::vector<std::future<void>> done;
+        for (std::size_t i = 0; i != tasks; ++i)
+          done.push_back(pool.submit(work));
+        for (auto& d : done)
+          d.get();
+      });
+      auto submit = [&pool](auto f) { pool.submit(std::move(f)); };
+      std::atomic<std::size_t> left{tree};
+      measure("packaged_task_pool", "fork_join", n, tree, [&] {
+        submit([&]() noexcept { fork(submit, depth, left); });
+        while (left.load() != 0)
+          std::this_thread::yield();
+      });
+    }
+    if (n == cores)
+      break;
+  }
+
+  // std::async starts a thread per task, so it is run on fewer tasks
+  std::size_t few = std::min<std::size_t>(tasks, 1024);
+  measure("std_async", "fan_out", cores, few, [&] {
+    std::vector<std::future<void>> done;
+    for (std::size_t i = 0; i != few; ++i)
+      done.push_back(std::async(std::launch::async, work));
+    for (auto& d : done)
+      d.get();
+  });
+}
@@ -0,0 +1,103 @@
+// Hot slot microbenchmark; prints CSV of nanoseconds per call through a
+// swappable function slot, called from many threads while another thread
+// swaps the slot's function, for a mutex guarded std::function and for
+// hot_slot with and without grace period tracking.
+// Usage: bench_hot_slot [calls per thread] [threads]
+//        (default 1<<20 calls, one thread per hardware thread)
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "function_adaptors.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+NOINLINE int f0(int x) noexcept { return x + 1; }
+NOINLINE int f1(int x) noexcept { return x ^ 1; }
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t calls = 1 << 20;
+unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+std::atomic<int> sink;
+
+// Locked a mutex guarded std::function, the usual hand-rolled slot
+struct Locked
+{
+  std::mutex m;
+  std::function<int(int)> f = f0;
+
+  int operator()(int x) { std::lock_guard<std::mutex> l{m}; return f(x); }
+  void swap(int (*g)(int) noexcept) { std::lock_guard<std::mutex> l{m}; f = g; }
+  void synchronize() {}
+};
+
+// measure(mechanism, slot) prints the CSV row for calls from each of the
+// threads while a swapper thread swaps, and synchronizes, continuously
+template <class Slot>
+void measure(char const* mechanism, Slot& slot)
+{
+  std::atomic<bool> done{false};
+  std::size_t swaps = 0;
+  std::thread swapper([&] {
+    for (; !done; ++swaps) {
+      slot.swap(swaps & 1 ? f1 : f0);
+      slot.synchronize();
+      std::this_thread::yield();
+    }
+  });
+
+  auto t0 = clock_type::now();
+  std::vector<std::thread> callers;
+  for (unsigned t = 0; t != threads; ++t)
+    callers.emplace_back([&] {
+      int sum = 0;
+      for (std::size_t i = 0; i != calls; ++i)
+        sum += slot(int(i));
+      sink += sum;
+    });
+  for (auto& c : callers)
+    c.join();
+  auto t1 = clock_type::now();
+  done = true;
+  swapper.join();
+
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%u,%zu,%.3f\n", mechanism, threads, swaps,
+              ns / double(calls));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    calls = std::strtoul(argv[1], nullptr, 10);
+  if (argc > 2)
+    threads = unsigned(std::strtoul(argv[2], nullptr, 10));
+
+  // wall clock time per call per thread; equal for perfect scaling
+  std::printf("mechanism,threads,swaps,ns_per_call\n");
+
+  Locked locked;
+  measure("mutex_std_function", locked);
+
+  struct Slot : ltl::hot_slot<int(int) noexcept>
+  {
+    using hot_slot::hot_slot;
+    void synchronize() {}
+  } slot{f0};
+  measure("hot_slot", slot);
+
+  ltl::hot_slot<int(int) noexcept, true> graced{f0};
+  measure("hot_slot_grace", graced);
+}
@@ -0,0 +1,66 @@
+// Instrumentation overhead benchmark; prints CSV of nanoseconds per call
+// of a small function called directly, through instrumented<&f> with
+// sampling disabled and enabled, and through a forwarding lambda held in
+// a std::function, against two clock reads, then the sampled latency
+// histogram of f as CSV.
+// Usage: bench_instrumented [calls]  (default 1<<22 calls)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include "function_adaptors.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+NOINLINE int f(int x) noexcept { return x * 3 + 1; }
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t calls = 1 << 22;
+volatile int sink;
+
+template <class F>
+void measure(char const* mechanism, F const& call)
+{
+  int sum = 0;
+  auto t0 = clock_type::now();
+  for (std::size_t i = 0; i != calls; ++i)
+    sum += call(int(i));
+  auto t1 = clock_type::now();
+  sink = sum;
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%.3f\n", mechanism, ns / double(calls));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    calls = std::strtoul(argv[1], nullptr, 10);
+
+  using Latency = ltl::latency_of<&f>;
+  auto volatile timed = ltl::instrumented<&f>;
+  std::function<int(int)> wrapped = [](auto&&... a) {
+    return f(std::forward<decltype(a)>(a)...);
+  };
+
+  std::printf("mechanism,ns_per_call\n");
+  measure("direct", f);
+  measure("instrumented_disabled", timed);
+  Latency::enable();
+  measure("instrumented_enabled", timed);
+  Latency::enable(false);
+  measure("std_function_lambda", wrapped);
+  measure("two_clock_reads", [](int x) {
+    auto t = clock_type::now();
+    return x + int((clock_type::now() - t).count() & 1);
+  });
+
+  std::printf("\n");
+  Latency::merge().write_csv(stdout);
+}
@@ -0,0 +1,99 @@
+// invoke benchmark; prints CSV of nanoseconds per call of a free function,
+// a lambda, a member function on an object, a pointer and a
+// std::reference_wrapper, and a data member, each called directly, by
+// ltl::invoke and by std::invoke. Built at -O0, -Og and -O2, which the
+// first argument names; unoptimized builds show std::invoke's call frames.
+// Usage: bench_invoke [build] [calls]  (default "-", 1<<22 calls)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include "function_adaptors.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+struct Counter
+{
+  int n = 0;
+  NOINLINE int add(int x) noexcept { return n += x; }
+};
+
+NOINLINE int add(int& n, int x) noexcept { return n += x; }
+
+using clock_type = std::chrono::steady_clock;
+
+char const* build = "-";
+std::size_t calls = 1 << 22;
+volatile int sink;
+
+template <class Call>
+void measure(char const* target, char const* mechanism, Call call)
+{
+  int sum = 0;
+  auto t0 = clock_type::now();
+  for (std::size_t i = 0; i != calls; ++i)
+    sum += call(int(i & 7));
+  auto t1 = clock_type::now();
+  sink = sum;
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%s,%s,%.3f\n", build, target, mechanism,
+              ns / double(calls));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    build = argv[1];
+  if (argc > 2)
+    calls = std::strtoul(argv[2], nullptr, 10);
+
+  Counter c;
+  Counter* p = &c;
+  auto r = std::ref(c);
+  int n = 0;
+  auto lambda = [&n](int x) noexcept { return n += x; };
+
+  std::printf("build,target,mechanism,ns_per_call\n");
+  measure("function", "direct", [&](int x) { return add(n, x); });
+  measure("function", "ltl_invoke",
+          [&](int x) { return ltl::invoke(add, n, x); });
+  measure("function", "std_invoke",
+          [&](int x) { return std::invoke(add, n, x); });
+
+  measure("lambda", "direct", [&](int x) { return lambda(x); });
+  measure("lambda", "ltl_invoke",
+          [&](int x) { return ltl::invoke(lambda, x); });
+  measure("lambda", "std_invoke",
+          [&](int x) { return std::invoke(lambda, x); });
+
+  measure("member_object", "direct", [&](int x) { return c.add(x); });
+  measure("member_object", "ltl_invoke",
+          [&](int x) { return ltl::invoke(&Counter::add, c, x); });
+  measure("member_object", "std_invoke",
+          [&](int x) { return std::invoke(&Counter::add, c, x); });
+
+  measure("member_pointer", "direct", [&](int x) { return p->add(x); });
+  measure("member_pointer", "ltl_invoke",
+          [&](int x) { return ltl::invoke(&Counter::add, p, x); });
+  measure("member_pointer", "std_invoke",
+          [&](int x) { return std::invoke(&Counter::add, p, x); });
+
+  measure("member_ref_wrapper", "direct",
+          [&](int x) { return r.get().add(x); });
+  measure("member_ref_wrapper", "ltl_invoke",
+          [&](int x) { return ltl::invoke(&Counter::add, r, x); });
+  measure("member_ref_wrapper", "std_invoke",
+          [&](int x) { return std::invoke(&Counter::add, r, x); });
+
+  measure("data_member", "direct", [&](int x) { return p->n + x; });
+  measure("data_member", "ltl_invoke",
+          [&](int x) { return ltl::invoke(&Counter::n, p) + x; });
+  measure("data_member", "std_invoke",
+          [&](int x) { return std::invoke(&Counter::n, p) + x; });
+}
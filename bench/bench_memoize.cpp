@@ -0,0 +1,100 @@
+// Memoization benchmark; prints CSV of nanoseconds per call of a pure
+// function through memoize_lru and memoize_sharded on cache hits and on
+// misses (a key cycle longer than the cache), against the direct call,
+// then per call of memoize_sharded on hits from 1, 2, 4, ... threads up
+// to the core count, for one shard (a single locked cache) and 16 shards.
+// Usage: bench_memoize [calls]  (default 1<<20 calls per thread)
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "function_adaptors.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+// collatz(n, limit) total steps of the Collatz sequences from n to n+15,
+// each up to limit steps
+NOINLINE long collatz(long n, int limit) noexcept
+{
+  long steps = 0;
+  for (long k = n; k != n + 16; ++k) {
+    long x = k;
+    for (int i = 0; x != 1 && i != limit; ++i, ++steps)
+      x = x % 2 ? 3 * x + 1 : x / 2;
+  }
+  return steps;
+}
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t calls = 1 << 20;
+std::atomic<long> sink;
+
+// run(f, keys) calls f on a cycle of keys distinct arguments
+template <class F>
+double run(F f, long keys)
+{
+  long sum = 0;
+  auto t0 = clock_type::now();
+  for (std::size_t i = 0; i != calls; ++i)
+    sum += f(27 + long(i) % keys, 1000);
+  auto t1 = clock_type::now();
+  sink += sum;
+  return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+template <class F>
+void measure(char const* mechanism, char const* load, F f, long keys)
+{
+  std::printf("%s,%s,1,%.3f\n", mechanism, load,
+              run(f, keys) / double(calls));
+}
+
+// contend(mechanism, f, threads) calls f on hits from each of threads
+template <class F>
+void contend(char const* mechanism, F f, unsigned threads)
+{
+  run(f, 64); // warm the cache
+  std::vector<std::thread> pool;
+  auto t0 = clock_type::now();
+  for (unsigned t = 0; t != threads; ++t)
+    pool.emplace_back([f] { run(f, 64); });
+  for (auto& t : pool)
+    t.join();
+  auto t1 = clock_type::now();
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,contended_hit,%u,%.3f\n", mechanism, threads,
+              ns / double(calls));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    calls = std::strtoul(argv[1], nullptr, 10);
+
+  // wall clock time per call per thread; equal for perfect scaling
+  std::printf("mechanism,load,threads,ns_per_call\n");
+  measure("direct", "none", collatz, 64);
+  measure("memoize_lru", "hit", ltl::memoize_lru<&collatz, 64>, 64);
+  measure("memoize_lru", "miss", ltl::memoize_lru<&collatz, 64>, 65);
+  measure("memoize_sharded", "hit", ltl::memoize_sharded<&collatz>, 64);
+  measure("memoize_sharded", "miss", ltl::memoize_sharded<&collatz, 64, 1>,
+          65);
+
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned n = 1;; n = std::min(2 * n, cores)) {
+    contend("one_shard", ltl::memoize_sharded<&collatz, 64, 1>, n);
+    contend("sixteen_shards", ltl::memoize_sharded<&collatz, 1024, 16>, n);
+    if (n == cores)
+      break;
+  }
+}
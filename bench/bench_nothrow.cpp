@@ -0,0 +1,110 @@
+// Exception boundary benchmark; prints CSV of nanoseconds per element of
+// loop kernels that sum f(v[i]) over an array where f never throws on the
+// happy path: calling a potentially throwing f directly, with one
+// try/catch around the loop, through nothrow<&f, &on_error> per call,
+// and, for a noexcept f, directly and through nothrow's pass through.
+// codegen_nothrow.py compiles this file to assembly and reports each
+// loop_ kernel's instruction count and exception landing pads.
+// Usage: bench_nothrow [passes]  (default 1<<14 passes over 4096 ints)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#include "function_adaptors.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+inline int checked(int x)
+{
+  if (x < 0)
+    throw std::domain_error("negative");
+  return x * 3;
+}
+inline int tripled(int x) noexcept { return x * 3; }
+
+std::optional<int> none() noexcept { return {}; }
+
+extern "C" NOINLINE long loop_direct(int const* v, std::size_t n)
+{
+  long sum = 0;
+  for (std::size_t i = 0; i != n; ++i)
+    sum += checked(v[i]);
+  return sum;
+}
+
+extern "C" NOINLINE long loop_guarded(int const* v, std::size_t n) noexcept
+{
+  try {
+    long sum = 0;
+    for (std::size_t i = 0; i != n; ++i)
+      sum += checked(v[i]);
+    return sum;
+  }
+  catch (...) {
+    return -1;
+  }
+}
+
+extern "C" NOINLINE long loop_nothrow(int const* v, std::size_t n) noexcept
+{
+  long sum = 0;
+  for (std::size_t i = 0; i != n; ++i)
+    if (auto r = ltl::nothrow<&checked, &none>(v[i]))
+      sum += *r;
+  return sum;
+}
+
+extern "C" NOINLINE long loop_noexcept(int const* v, std::size_t n) noexcept
+{
+  long sum = 0;
+  for (std::size_t i = 0; i != n; ++i)
+    sum += tripled(v[i]);
+  return sum;
+}
+
+extern "C" NOINLINE long loop_pass_through(int const* v, std::size_t n) noexcept
+{
+  long sum = 0;
+  for (std::size_t i = 0; i != n; ++i)
+    sum += *ltl::nothrow<&tripled, &none>(v[i]);
+  return sum;
+}
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t passes = 1 << 14;
+std::vector<int> v(4096, 7);
+volatile long sink;
+
+void measure(char const* kernel, long (*loop)(int const*, std::size_t))
+{
+  long sum = 0;
+  auto t0 = clock_type::now();
+  for (std::size_t p = 0; p != passes; ++p)
+    sum += loop(v.data(), v.size());
+  auto t1 = clock_type::now();
+  sink = sum;
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%.4f\n", kernel, ns / double(passes * v.size()));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    passes = std::strtoul(argv[1], nullptr, 10);
+
+  std::printf("kernel,ns_per_element\n");
+  measure("loop_direct", loop_direct);
+  measure("loop_guarded", loop_guarded);
+  measure("loop_nothrow", loop_nothrow);
+  measure("loop_noexcept", loop_noexcept);
+  measure("loop_pass_through", loop_pass_through);
+}
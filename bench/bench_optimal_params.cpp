@@ -0,0 +1,126 @@
+// Parameter passing benchmark; prints CSV of nanoseconds per call of
+// call-heavy kernels over noinline functions of small trivially copyable
+// structs taken by const&, as generated interfaces take them, and of the
+// same functions declared with function_optimal_params_t, taking them by
+// value in registers, and through the optimal_params<&f> adaptor; for a
+// two double Vec (two SSE registers each) and a two word Key (one GPR).
+// Usage: bench_optimal_params [calls]  (default 1<<24 calls)
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "function_adaptors.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+struct Vec { double x, y; };
+struct Key { std::uint32_t lo, hi; };
+
+using Dot = double(Vec const&, Vec const&) noexcept;
+using Step = Vec(Vec const&, Vec const&) noexcept;
+using Mix = Key(Key const&, Key const&) noexcept;
+
+// the *_value functions are declared by their optimal parameter types
+ltl::function_optimal_params_t<Dot> dot_value;
+ltl::function_optimal_params_t<Step> step_value;
+ltl::function_optimal_params_t<Mix> mix_value;
+
+NOINLINE double dot_ref(Vec const& a, Vec const& b) noexcept
+{
+  return a.x * b.x + a.y * b.y;
+}
+NOINLINE double dot_value(Vec a, Vec b) noexcept
+{
+  return a.x * b.x + a.y * b.y;
+}
+NOINLINE Vec step_ref(Vec const& v, Vec const& d) noexcept
+{
+  return {v.x * 0.999 + d.x, v.y * 0.999 + d.y};
+}
+NOINLINE Vec step_value(Vec v, Vec d) noexcept
+{
+  return {v.x * 0.999 + d.x, v.y * 0.999 + d.y};
+}
+NOINLINE Key mix_ref(Key const& k, Key const& s) noexcept
+{
+  return {k.hi ^ (k.lo * 0x9E3779B9u), k.lo + s.hi};
+}
+NOINLINE Key mix_value(Key k, Key s) noexcept
+{
+  return {k.hi ^ (k.lo * 0x9E3779B9u), k.lo + s.hi};
+}
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t calls = 1 << 24;
+std::vector<double> xs(1024, 0.5), ys(1024, 0.25);
+volatile double sink;
+
+// dots(f) sums f over vectors built in registers from two arrays
+template <class F>
+double dots(F f)
+{
+  double sum = 0;
+  for (std::size_t i = 0; i != calls; ++i) {
+    std::size_t k = i & 1023;
+    sum += f(Vec{xs[k], ys[k]}, Vec{ys[k], xs[k]});
+  }
+  return sum;
+}
+
+// steps(f) chains f, each result the next call's argument
+template <class F>
+double steps(F f)
+{
+  Vec v{1, 2};
+  for (std::size_t i = 0; i != calls; ++i)
+    v = f(v, Vec{xs[i & 1023], 0.125});
+  return v.x + v.y;
+}
+
+// mixes(f) chains f over keys, each result the next call's argument
+template <class F>
+double mixes(F f)
+{
+  Key k{1, 2};
+  for (std::size_t i = 0; i != calls; ++i)
+    k = f(k, Key{0, std::uint32_t(i)});
+  return k.lo + k.hi;
+}
+
+template <class Kernel>
+void measure(char const* kernel, char const* passing, Kernel run)
+{
+  auto t0 = clock_type::now();
+  sink = run();
+  auto t1 = clock_type::now();
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%s,%.3f\n", kernel, passing, ns / double(calls));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    calls = std::strtoul(argv[1], nullptr, 10);
+
+  std::printf("kernel,passing,ns_per_call\n");
+  measure("dot", "const_ref", [] { return dots(dot_ref); });
+  measure("dot", "optimal_value", [] { return dots(dot_value); });
+  measure("dot", "optimal_params_adaptor",
+          [] { return dots(ltl::optimal_params<&dot_ref>); });
+  measure("step_chain", "const_ref", [] { return steps(step_ref); });
+  measure("step_chain", "optimal_value", [] { return steps(step_value); });
+  measure("step_chain", "optimal_params_adaptor",
+          [] { return steps(ltl::optimal_params<&step_ref>); });
+  measure("mix_chain", "const_ref", [] { return mixes(mix_ref); });
+  measure("mix_chain", "optimal_value", [] { return mixes(mix_value); });
+  measure("mix_chain", "optimal_params_adaptor",
+          [] { return mixes(ltl::optimal_params<&mix_ref>); });
+}
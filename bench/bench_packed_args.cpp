@@ -0,0 +1,136 @@
+// Packed argument storage benchmark; prints CSV of sizeof a std::tuple of
+// the decayed parameters, in declaration order, and of packed_args<F>
+// for each signature of a corpus of deferred call signatures, then of
+// nanoseconds per call to queue, and later run, many pending calls held
+// in a vector of each, with the bytes the queue holds.
+// Usage: bench_packed_args [calls]  (default 1<<20 pending calls)
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "function_adaptors.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+using std::int8_t;
+using std::int16_t;
+using std::int32_t;
+using std::int64_t;
+using std::uint8_t;
+using std::uint16_t;
+using std::uint32_t;
+using std::uint64_t;
+
+// CORPUS(X) X(name, signature) for each signature of the corpus
+#define CORPUS(X)                                                           \
+  X(mixed, void(char, double, char, long long))                            \
+  X(flags, void(bool, int64_t, bool, int32_t, bool))                       \
+  X(log_record, void(uint8_t, double, uint16_t, void const*, uint32_t))    \
+  X(poll, void(int, short, void*))                                         \
+  X(connection, void(uint16_t, uint64_t, uint8_t, double))                 \
+  X(samples, void(float, double, float))                                   \
+  X(triple, void(int, int, int))                                           \
+  X(bytes, void(int8_t, int64_t, int8_t, int64_t, int8_t))                 \
+  X(buffer, void(char const*, std::size_t, bool))                          \
+  X(handles, void(uint32_t, void*, uint32_t, void*))                       \
+  X(named, void(char, std::string, char))                                  \
+  X(shared, void(bool, std::shared_ptr<int>, bool))                        \
+  X(geometry, void(float, float, double, float, int16_t))                  \
+  X(timer, void(bool, uint64_t, uint32_t, bool, void (*)()))
+
+template <typename F> struct decayed_tuple;
+template <typename... P> struct decayed_tuple<void(P...)>
+{
+  using type = std::tuple<std::decay_t<P>...>;
+};
+
+void report()
+{
+  std::printf("signature,tuple_bytes,packed_bytes,saved_percent\n");
+  std::size_t tuples = 0, packed = 0;
+#define ROW(NAME, ...)                                                      \
+  {                                                                         \
+    std::size_t t = sizeof(decayed_tuple<__VA_ARGS__>::type);               \
+    std::size_t p = sizeof(ltl::packed_args<__VA_ARGS__>);                  \
+    tuples += t;                                                            \
+    packed += p;                                                            \
+    std::printf("%s,%zu,%zu,%.1f\n", #NAME, t, p,                           \
+                100.0 * double(t - p) / double(t));                         \
+  }
+  CORPUS(ROW)
+#undef ROW
+  std::printf("corpus_total,%zu,%zu,%.1f\n\n", tuples, packed,
+              100.0 * double(tuples - packed) / double(tuples));
+}
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t calls = 1 << 20;
+double total;
+
+NOINLINE void mixed(char a, double b, char c, long long d) noexcept
+{
+  total += a + b + c + double(d);
+}
+NOINLINE void flags(bool a, int64_t b, bool c, int32_t d, bool e) noexcept
+{
+  total += a + double(b) + c + d + e;
+}
+
+// deferred<F, f, packed>(name, make) queues pending calls of f with the
+// arguments make(i) returns, as packed_args<F> or a tuple, then runs all
+template <typename F, auto f, bool packed, class Make>
+void deferred(char const* name, Make make)
+{
+  using Store = std::conditional_t<packed, ltl::packed_args<F>,
+                                   typename decayed_tuple<F>::type>;
+  auto t0 = clock_type::now();
+  std::vector<Store> queue;
+  queue.reserve(calls);
+  for (std::size_t i = 0; i != calls; ++i)
+    std::apply([&](auto... a) { queue.emplace_back(a...); }, make(i));
+  for (auto& call : queue) {
+    if constexpr (packed)
+      call.apply(f);
+    else
+      std::apply(f, call);
+  }
+  auto t1 = clock_type::now();
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%s,%zu,%.3f\n", name, packed ? "packed_args" : "tuple",
+              sizeof(Store) * calls, ns / double(calls));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    calls = std::strtoul(argv[1], nullptr, 10);
+
+  report();
+
+  std::printf("signature,storage,queue_bytes,ns_per_call\n");
+  auto make_mixed = [](std::size_t i) {
+    return std::make_tuple(char(i), double(i), char(i >> 8), (long long)i);
+  };
+  auto make_flags = [](std::size_t i) {
+    return std::make_tuple(bool(i & 1), int64_t(i), bool(i & 2),
+                           int32_t(i), bool(i & 4));
+  };
+  using Mixed = void(char, double, char, long long);
+  using Flags = void(bool, int64_t, bool, int32_t, bool);
+  deferred<Mixed, &mixed, false>("mixed", make_mixed);
+  deferred<Mixed, &mixed, true>("mixed", make_mixed);
+  deferred<Flags, &flags, false>("flags", make_flags);
+  deferred<Flags, &flags, true>("flags", make_flags);
+  std::printf("\ntotal,%.0f\n", total);
+}
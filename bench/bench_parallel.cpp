@@ -0,0 +1,88 @@
+// Parallel apply benchmark; prints CSV of nanoseconds per element of
+// out[i] = f(in[i]) over a large array, by a serial loop, by
+// parallel_apply on an executor of 1, 2, 4, ... workers, the caller
+// working too, up to the core count, and by std::transform with
+// std::execution::par if built with STD_PAR (all cores), then the time
+// per call of each on a small array, for the per call cost.
+// Usage: bench_parallel [elements] [passes]  (default 1<<22, 8)
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "function_adaptors.hpp"
+#if defined(STD_PAR)
+#   include <execution>
+#endif
+
+// f(x) a few dozen dependent multiply-adds
+double f(double x) noexcept
+{
+  for (int k = 0; k != 32; ++k)
+    x = x * 0.999 + 0.5;
+  return x;
+}
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t elements = 1 << 22;
+std::size_t passes = 8;
+std::vector<double> in, out;
+
+template <class Pass>
+void measure(char const* mechanism, unsigned threads, std::size_t n,
+             std::size_t times, Pass pass)
+{
+  auto t0 = clock_type::now();
+  for (std::size_t p = 0; p != times; ++p)
+    pass();
+  auto t1 = clock_type::now();
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%u,%zu,%.3f\n", mechanism, threads, n,
+              ns / double(n * times));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    elements = std::strtoul(argv[1], nullptr, 10);
+  if (argc > 2)
+    passes = std::strtoul(argv[2], nullptr, 10);
+  in.assign(elements, 1.0);
+  out.assign(elements, 0.0);
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+
+  std::printf("mechanism,threads,elements,ns_per_element\n");
+  measure("serial", 1, elements, passes, [] {
+    for (std::size_t i = 0; i != elements; ++i)
+      out[i] = f(in[i]);
+  });
+  unsigned const top = std::max(1u, cores - 1);
+  for (unsigned w = 1;; w = std::min(2 * w, top)) {
+    ltl::executor ex{w};
+    measure("parallel_apply", w + 1, elements, passes, [&] {
+      ltl::parallel_apply<&f>(ex, in, out);
+    });
+    if (w == top)
+      break;
+  }
+#if defined(STD_PAR)
+  measure("std_transform_par", cores, elements, passes, [] {
+    std::transform(std::execution::par, in.begin(), in.end(), out.begin(),
+                   f);
+  });
+#endif
+
+  // per call cost on 8k elements, spread over all cores
+  std::size_t const small = 1 << 13;
+  std::vector<double> a(small, 1.0), b(small);
+  measure("parallel_apply_small", cores, small, 1000, [&] {
+    ltl::parallel_apply<&f>(a, b);
+  });
+#if defined(STD_PAR)
+  measure("std_transform_par_small", cores, small, 1000, [&] {
+    std::transform(std::execution::par, a.begin(), a.end(), b.begin(), f);
+  });
+#endif
+}
@@ -0,0 +1,119 @@
+// Polymorphic value microbenchmark; prints CSV of nanoseconds per call of
+// an area method over a shuffled array of four model types, by virtual
+// dispatch on heap objects and by ltl::poly, through its vtable and as a
+// hot method held in the object. Models are made by a non-inlined factory
+// from runtime random kinds, so no call can be devirtualized.
+// Usage: bench_poly [objects] [passes]  (default 1<<12 objects, 256 passes)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+#include "function_adaptors.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+// Virtual interface and models
+struct Base
+{
+  virtual long area() const = 0;
+  virtual ~Base() = default;
+};
+template <int I> struct Virtual : Base
+{
+  long a, b;
+  Virtual(long x, long y) : a{x}, b{y} {}
+  long area() const override { return a * b + I; }
+};
+
+// Static interface and models
+struct area {
+  template <class T> long operator()(T const& t) const { return t.area(); }
+};
+using Area = ltl::method<area, long() const>;
+using Shape = ltl::vtable<Area>;
+
+template <int I> struct Model
+{
+  long a, b;
+  long area() const { return a * b + I; }
+};
+
+using Cold = ltl::poly<Shape, 2 * sizeof(long)>;
+using Hot = ltl::poly<Shape, 2 * sizeof(long), Shape>;
+
+NOINLINE std::unique_ptr<Base> make_virtual(unsigned k, long x)
+{
+  switch (k) {
+    case 0: return std::make_unique<Virtual<0>>(x, 2);
+    case 1: return std::make_unique<Virtual<1>>(x, 3);
+    case 2: return std::make_unique<Virtual<2>>(x, 5);
+    default: return std::make_unique<Virtual<3>>(x, 7);
+  }
+}
+
+template <class Poly>
+NOINLINE Poly make_poly(unsigned k, long x)
+{
+  switch (k) {
+    case 0: return Model<0>{x, 2};
+    case 1: return Model<1>{x, 3};
+    case 2: return Model<2>{x, 5};
+    default: return Model<3>{x, 7};
+  }
+}
+
+using clock_type = std::chrono::steady_clock;
+volatile long sink;
+
+template <class V, class Area>
+void measure(char const* mechanism, V const& v, std::size_t passes,
+             Area area)
+{
+  auto t0 = clock_type::now();
+  long sum = 0;
+  for (std::size_t p = 0; p != passes; ++p)
+    for (auto const& x : v)
+      sum += area(x);
+  auto t1 = clock_type::now();
+  sink = sum;
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%zu,%.3f\n", mechanism, v.size(),
+              ns / double(passes * v.size()));
+}
+
+int main(int argc, char** argv)
+{
+  std::size_t objects = argc > 1 ? std::strtoul(argv[1], nullptr, 10)
+                                 : 1 << 12;
+  std::size_t passes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256;
+
+  std::mt19937 rng{42};
+  std::vector<unsigned> kinds;
+  for (std::size_t i = 0; i != objects; ++i)
+    kinds.push_back(rng() % 4);
+
+  std::vector<std::unique_ptr<Base>> virtuals;
+  std::vector<Cold> colds;
+  std::vector<Hot> hots;
+  for (std::size_t i = 0; i != objects; ++i) {
+    virtuals.push_back(make_virtual(kinds[i], long(i)));
+    colds.push_back(make_poly<Cold>(kinds[i], long(i)));
+    hots.push_back(make_poly<Hot>(kinds[i], long(i)));
+  }
+
+  std::printf("mechanism,objects,ns_per_call\n");
+  measure("virtual", virtuals, passes,
+          [](auto const& p) { return p->area(); });
+  measure("poly", colds, passes,
+          [](auto const& p) { return p.template call<area>(); });
+  measure("poly_hot", hots, passes,
+          [](auto const& p) { return p.template call<area>(); });
+}
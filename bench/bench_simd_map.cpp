@@ -0,0 +1,96 @@
+// Lane-batched mapping benchmark; prints CSV of millions of elements per
+// second of out[i] = f(a[i], b[i], c[i]) for float f(float, float, int)
+// by a plain scalar loop and by simd_map at 1, 2, 4, ... 32 lanes and at
+// the vector's own lane count (0), for each instruction set the CPU runs.
+// Usage: bench_simd_map [elements] [passes]  (default 1<<16, 2000)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "function_adaptors.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+inline float kernel(float a, float b, int c) noexcept
+{
+  return a * b + float(c) * 0.5f;
+}
+
+using clock_type = std::chrono::steady_clock;
+using map_type = void (*)(std::size_t, float*, float const*, float const*,
+                          int const*) noexcept;
+
+std::size_t elements = 1 << 16;
+std::size_t passes = 2000;
+std::vector<float> a, b, out;
+std::vector<int> c;
+volatile float sink;
+
+NOINLINE void scalar(std::size_t n, float* o, float const* x, float const* y,
+                     int const* z) noexcept
+{
+  for (std::size_t i = 0; i != n; ++i)
+    o[i] = kernel(x[i], y[i], z[i]);
+}
+
+void measure(char const* isa, int lanes, map_type map)
+{
+  auto t0 = clock_type::now();
+  for (std::size_t p = 0; p != passes; ++p)
+    map(elements, out.data(), a.data(), b.data(), c.data());
+  auto t1 = clock_type::now();
+  sink = out[elements / 2];
+  double s = std::chrono::duration<double>(t1 - t0).count();
+  std::printf("%s,%d,%.1f\n", isa, lanes,
+              double(elements) * double(passes) / s / 1e6);
+}
+
+// widths(isa, pick) rows for each lane width W of the clone pick<W>()
+template <class Pick>
+void widths(char const* isa, Pick pick)
+{
+  measure(isa, 1, pick(std::integral_constant<std::size_t, 1>{}));
+  measure(isa, 2, pick(std::integral_constant<std::size_t, 2>{}));
+  measure(isa, 4, pick(std::integral_constant<std::size_t, 4>{}));
+  measure(isa, 8, pick(std::integral_constant<std::size_t, 8>{}));
+  measure(isa, 16, pick(std::integral_constant<std::size_t, 16>{}));
+  measure(isa, 32, pick(std::integral_constant<std::size_t, 32>{}));
+  measure(isa, 0, pick(std::integral_constant<std::size_t, 0>{}));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    elements = std::strtoul(argv[1], nullptr, 10);
+  if (argc > 2)
+    passes = std::strtoul(argv[2], nullptr, 10);
+  a.assign(elements, 1.5f);
+  b.assign(elements, 2.f);
+  c.assign(elements, 3);
+  out.assign(elements, 0.f);
+
+  std::printf("isa,lanes,melements_per_s\n");
+  measure("scalar_loop", 1, scalar);
+  widths("baseline", [](auto w) -> map_type {
+    return ltl::impl::simd_map<&kernel, w>::baseline;
+  });
+#if (defined(__GNUC__) || defined(__clang__)) \
+ && (defined(__x86_64__) || defined(__i386__))
+  if (__builtin_cpu_supports("avx2"))
+    widths("avx2", [](auto w) -> map_type {
+      return ltl::impl::simd_map<&kernel, w>::avx2;
+    });
+  if (__builtin_cpu_supports("avx512f"))
+    widths("avx512f", [](auto w) -> map_type {
+      return ltl::impl::simd_map<&kernel, w>::avx512;
+    });
+#endif
+  std::printf("\nselected,%s\n", ltl::simd_isa());
+  measure("simd_map", 0, ltl::simd_map<&kernel>);
+}
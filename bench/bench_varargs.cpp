@@ -0,0 +1,87 @@
+// Varargs forwarding microbenchmark; prints CSV of nanoseconds per call of
+// a printf-style logging wrapper that passes its va_list on to vlog, by
+// variadic_forwarder and by hand, against formatting into a temporary
+// buffer and then passing the formatted line on.
+// Usage: bench_varargs [calls]  (default 1<<20 calls)
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "function_adaptors.hpp"
+
+#if defined(__GNUC__)
+#   define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+#   define NOINLINE __declspec(noinline)
+#else
+#   define NOINLINE
+#endif
+
+// Sink a log line buffer; log is declared only, for its type
+struct Sink
+{
+  char line[256];
+  int log(char const* fmt, ...);
+  NOINLINE int vlog(char const* fmt, std::va_list args)
+  {
+    return std::vsnprintf(line, sizeof line, fmt, args);
+  }
+  NOINLINE int write(char const* msg)
+  {
+    std::size_t n = std::strlen(msg);
+    std::memcpy(line, msg, n + 1);
+    return int(n);
+  }
+};
+
+constexpr auto forwarded = ltl::variadic_forwarder<&Sink::log, &Sink::vlog>;
+
+NOINLINE int by_hand(Sink& s, char const* fmt, ...)
+{
+  std::va_list args;
+  va_start(args, fmt);
+  int n = s.vlog(fmt, args);
+  va_end(args);
+  return n;
+}
+
+NOINLINE int format_then_forward(Sink& s, char const* fmt, ...)
+{
+  char tmp[256];
+  std::va_list args;
+  va_start(args, fmt);
+  std::vsnprintf(tmp, sizeof tmp, fmt, args);
+  va_end(args);
+  return s.write(tmp);
+}
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t calls = 1 << 20;
+volatile int sink;
+
+template <class Log>
+void measure(char const* mechanism, Log log)
+{
+  Sink s;
+  int n = 0;
+  auto t0 = clock_type::now();
+  for (std::size_t i = 0; i != calls; ++i)
+    n += log(s, "%s %d: %.2f in %s\n", "event", int(i), i * 0.25, "bench");
+  auto t1 = clock_type::now();
+  sink = n + s.line[0];
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%.3f\n", mechanism, ns / double(calls));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    calls = std::strtoul(argv[1], nullptr, 10);
+
+  std::printf("mechanism,ns_per_call\n");
+  measure("variadic_forwarder", forwarded);
+  measure("by_hand", by_hand);
+  measure("format_then_forward", format_then_forward);
+}
@@ -0,0 +1,125 @@
+// Dispatch table vs std::visit benchmark; prints CSV of nanoseconds per
+// message of a sequence of messages of ALTERNATIVES types, in random
+// order, handled by dispatch_table<&handle<I>...> given the index and a
+// pointer, and by std::visit on a std::variant of the message types.
+// Also the corpus of compile_time_visit.py, which compiles it for only one
+// MECHANISM (1 dispatch_table, 2 std::visit) at 8, 64 and 256 types.
+// Usage: bench_visit [passes]  (default 1<<10 passes over 1<<12 messages)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+#include "function_adaptors.hpp"
+
+#ifndef ALTERNATIVES
+#   define ALTERNATIVES 8
+#endif
+#ifndef MECHANISM
+#   define MECHANISM 0
+#endif
+#if MECHANISM != 1
+#   include <variant>
+#endif
+
+template <std::size_t I> struct Msg { int v; };
+
+template <std::size_t I> int handle(Msg<I>& m) noexcept
+{
+  return m.v * int(I % 7 + 1);
+}
+
+using each = std::make_index_sequence<ALTERNATIVES>;
+
+#if MECHANISM != 2
+// msg<I> the message of type I that dispatch_table's messages point to
+template <std::size_t I> Msg<I> msg{int(I)};
+
+template <class> struct table;
+template <std::size_t... I>
+struct table<std::index_sequence<I...>>
+{
+  using type = ltl::dispatch_table<&handle<I>...>;
+
+  // pointer(i) the address of msg<i>
+  static void* pointer(std::size_t i)
+  {
+    static void* const all[] = {&msg<I>...};
+    return all[i];
+  }
+};
+#endif
+
+#if MECHANISM != 1
+template <class> struct variant;
+template <std::size_t... I>
+struct variant<std::index_sequence<I...>>
+{
+  using type = std::variant<Msg<I>...>;
+
+  // make(i) a variant holding a message of type i
+  static type make(std::size_t i)
+  {
+    static type const all[] = {Msg<I>{int(I)}...};
+    return all[i];
+  }
+};
+#endif
+
+using clock_type = std::chrono::steady_clock;
+
+std::size_t passes = 1 << 10;
+std::size_t const messages = 1 << 12;
+volatile int sink;
+
+template <class Pass>
+void measure(char const* mechanism, Pass pass)
+{
+  int sum = 0;
+  auto t0 = clock_type::now();
+  for (std::size_t p = 0; p != passes; ++p)
+    sum += pass();
+  auto t1 = clock_type::now();
+  sink = sum;
+  double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+  std::printf("%s,%d,%.3f\n", mechanism, ALTERNATIVES,
+              ns / double(passes * messages));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1)
+    passes = std::strtoul(argv[1], nullptr, 10);
+
+  std::mt19937 rng{42};
+  std::uniform_int_distribution<std::size_t> pick{0, ALTERNATIVES - 1};
+  std::vector<std::size_t> order;
+  for (std::size_t k = 0; k != messages; ++k)
+    order.push_back(pick(rng));
+
+  std::printf("mechanism,alternatives,ns_per_message\n");
+#if MECHANISM != 2
+  struct tagged { std::size_t index; void* msg; };
+  std::vector<tagged> tags;
+  for (std::size_t i : order)
+    tags.push_back({i, table<each>::pointer(i)});
+  measure("dispatch_table", [&] {
+    int sum = 0;
+    for (auto const& t : tags)
+      sum += table<each>::type::call(t.index, t.msg);
+    return sum;
+  });
+#endif
+#if MECHANISM != 1
+  std::vector<variant<each>::type> msgs;
+  for (std::size_t i : order)
+    msgs.push_back(variant<each>::make(i));
+  measure("std_visit", [&] {
+    int sum = 0;
+    for (auto& v : msgs)
+      sum += std::visit([](auto& m) { return handle(m); }, v);
+    return sum;
+  });
+#endif
+}
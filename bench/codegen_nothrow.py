@@ -0,0 +1,46 @@
+#!/usr/bin/env python3
+# Codegen report for bench_nothrow.cpp; prints CSV of the instructions of
+# each loop_ kernel compiled at -O2 by GCC or Clang, in its hot body and
+# in any split out cold part, with its calls, and whether it has a
+# language specific data area (.cfi_lsda), i.e. exception landing pads.
+# Usage: codegen_nothrow.py source_dir compiler [compiler args...]
+import os
+import re
+import subprocess
+import sys
+
+source, compiler = sys.argv[1], sys.argv[2:]
+bench = os.path.join(source, 'bench', 'bench_nothrow.cpp')
+if os.path.basename(compiler[0]).lower() in ('cl', 'cl.exe'):
+    print('codegen report needs GCC or Clang assembly; skipped')
+    sys.exit(0)
+
+asm = subprocess.run(compiler + ['-std=c++17', '-O2', '-S', '-o', '-',
+                                 '-I' + source, bench],
+                     check=True, capture_output=True, text=True).stdout
+
+# kernel name -> [hot instructions, cold instructions, calls, lsda]
+kernels = {}
+current = None
+for line in asm.splitlines():
+    label = re.match(r'^_?(loop_\w+?)(\.cold\S*)?:$', line)
+    if label:
+        current = kernels.setdefault(label.group(1), [0, 0, 0, False])
+        cold = label.group(2) is not None
+        continue
+    if current is None:
+        continue
+    if line.startswith('\t.cfi_endproc') or re.match(r'^\S+:$', line) \
+       and not line.startswith('.L'):
+        current = None
+        continue
+    if '.cfi_lsda' in line:
+        current[3] = True
+    elif line.startswith('\t') and not line.startswith('\t.'):
+        current[1 if cold else 0] += 1
+        if re.match(r'\t(call|bl)\b', line):
+            current[2] += 1
+
+print('kernel,hot_instructions,cold_instructions,calls,landing_pads')
+for name, (hot, cold, calls, lsda) in kernels.items():
+    print('%s,%d,%d,%d,%s' % (name, hot, cold, calls, 'yes' if lsda else 'no'))
@@ -0,0 +1,32 @@
+#!/usr/bin/env python3
+# Compile-time benchmark; prints CSV of milliseconds to compile, syntax only,
+# compile_time_corpus.cpp with noexcept deduced and not deduced
+# (LTL_NO_NOEXCEPT_DEDUCTION), best of several runs of each.
+# Usage: compile_time.py source_dir compiler [compiler args...]
+#        (CORPUS_SIZE and RUNS may be set in the environment)
+import os
+import subprocess
+import sys
+import time
+
+source, compiler = sys.argv[1], sys.argv[2:]
+corpus = os.path.join(source, 'bench', 'compile_time_corpus.cpp')
+size = os.environ.get('CORPUS_SIZE', '16')
+runs = int(os.environ.get('RUNS', '3'))
+
+msvc = os.path.basename(compiler[0]).lower() in ('cl', 'cl.exe')
+flag = '/' if msvc else '-'
+args = ['/Zs', '/std:c++17'] if msvc else ['-fsyntax-only', '-std=c++17']
+args += [flag + 'I' + source, flag + 'DCORPUS_SIZE=' + size, corpus]
+
+print('config,corpus_size,ms')
+for config, define in (('noexcept_deduced', []),
+                       ('noexcept_not_deduced',
+                        [flag + 'DLTL_NO_NOEXCEPT_DEDUCTION'])):
+    best = None
+    for _ in range(runs):
+        t0 = time.perf_counter()
+        subprocess.run(compiler + define + args, check=True)
+        ms = (time.perf_counter() - t0) * 1000
+        best = ms if best is None else min(best, ms)
+    print('%s,%s,%.1f' % (config, size, best))
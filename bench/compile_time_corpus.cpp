@@ -0,0 +1,44 @@
+// Compile-time benchmark corpus: function_traits of all 48 qualifier and
+// varargs variants of CORPUS_SIZE distinct signatures. Compiled, syntax
+// only, by compile_time.py with and without LTL_NO_NOEXCEPT_DEDUCTION.
+#include <type_traits>
+#include <utility>
+#include "function_traits.hpp"
+
+#ifndef CORPUS_SIZE
+#   define CORPUS_SIZE 16
+#endif
+
+template <int I> struct A {};
+
+// touch<F> instantiates F's function_traits and a few of its aliases
+template <typename F>
+constexpr int touch = ltl::function_is_const_v<F>
+  + ltl::function_is_noexcept_v<ltl::function_remove_cvref_t<F>>
+  + std::is_same_v<ltl::function_set_noexcept_t<F, true>, F>
+  + std::is_same_v<ltl::function_signature_t<F>, void()>;
+
+// VARIANTS(params...) touch of the 24 cvref and noexcept variants of
+// void(params...)
+#define VARIANT(CV, REF, ...)                                               \
+  touch<void(__VA_ARGS__) CV REF> + touch<void(__VA_ARGS__) CV REF noexcept>
+#define VARIANTS(...)                                                       \
+  VARIANT(, , __VA_ARGS__) + VARIANT(const, , __VA_ARGS__)                  \
+  + VARIANT(volatile, , __VA_ARGS__) + VARIANT(const volatile, , __VA_ARGS__)\
+  + VARIANT(, &, __VA_ARGS__) + VARIANT(const, &, __VA_ARGS__)              \
+  + VARIANT(volatile, &, __VA_ARGS__)                                       \
+  + VARIANT(const volatile, &, __VA_ARGS__)                                 \
+  + VARIANT(, &&, __VA_ARGS__) + VARIANT(const, &&, __VA_ARGS__)            \
+  + VARIANT(volatile, &&, __VA_ARGS__)                                      \
+  + VARIANT(const volatile, &&, __VA_ARGS__)
+
+template <int I>
+constexpr int corpus = VARIANTS(A<I>) + VARIANTS(A<I>, ...);
+
+// all<0..CORPUS_SIZE-1> instantiates each corpus in its own unit base
+template <int I> struct unit { static_assert(corpus<I> != 0); };
+template <int... I> struct all : unit<I>... {};
+template <int... I> all<I...> make(std::integer_sequence<int, I...>);
+
+static constexpr auto corpus_size
+  = sizeof(decltype(make(std::make_integer_sequence<int, CORPUS_SIZE>{})));
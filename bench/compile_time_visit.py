@@ -0,0 +1,36 @@
+#!/usr/bin/env python3
+# Compile-time benchmark; prints CSV of milliseconds to compile, to an
+# object file at -O2, bench_visit.cpp for dispatch_table only and for
+# std::visit only, at 8, 64 and 256 message types, best of several runs.
+# Usage: compile_time_visit.py source_dir compiler [compiler args...]
+#        (RUNS may be set in the environment)
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+source, compiler = sys.argv[1], sys.argv[2:]
+corpus = os.path.join(source, 'bench', 'bench_visit.cpp')
+runs = int(os.environ.get('RUNS', '3'))
+
+msvc = os.path.basename(compiler[0]).lower() in ('cl', 'cl.exe')
+flag = '/' if msvc else '-'
+
+print('mechanism,alternatives,ms')
+with tempfile.TemporaryDirectory() as tmp:
+    obj = os.path.join(tmp, 'bench_visit.o')
+    args = (['/c', '/O2', '/EHsc', '/std:c++17', '/Fo' + obj] if msvc
+            else ['-c', '-O2', '-std=c++17', '-o', obj])
+    args += [flag + 'I' + source, corpus]
+    for alternatives in (8, 64, 256):
+        for mechanism, define in (('dispatch_table', 1), ('std_visit', 2)):
+            defines = [flag + 'DALTERNATIVES=%d' % alternatives,
+                       flag + 'DMECHANISM=%d' % define]
+            best = None
+            for _ in range(runs):
+                t0 = time.perf_counter()
+                subprocess.run(compiler + defines + args, check=True)
+                ms = (time.perf_counter() - t0) * 1000
+                best = ms if best is None else min(best, ms)
+            print('%s,%d,%.1f' % (mechanism, alternatives, best))
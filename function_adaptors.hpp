@@ -0,0 +1,3311 @@
+//    Copyright (c) 2019 Will Wray https://keybase.io/willwray
+//
+//   Distributed under the Boost Software License, Version 1.0.
+//          (http://www.boost.org/LICENSE_1_0.txt)
+//
+//   Repo: https://github.com/willwray/function_traits
+
+#ifndef LTL_FUNCTION_ADAPTORS_HPP
+#define LTL_FUNCTION_ADAPTORS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine)
+#   include <coroutine>
+#endif
+
+#include "function_traits.hpp"
+
+/*
+  "function_adaptors.hpp": functions generated from function types
+   ^^^^^^^^^^^^^^^^^^^^^
+   A companion to "function_traits.hpp". Where the traits header only
+   reflects and modifies function types, this header uses the traits
+   to generate functions with exactly computed types; no std::function,
+   no type-erased heap state, no change to parameter types or noexcept.
+
+   C callback thunks
+   =================
+   C APIs take callbacks with a 'user data' pointer; R(*)(void*, P...)
+
+     c_thunk<&C::f, I>    // plain function pointer that calls member C::f
+                          // on the C object pointed to by its void* arg
+     c_thunk_for<L, I>    // c_thunk<&L::operator(), I> for lambda type L
+
+   The thunk parameter list is function_arg_types of C::f with void* user
+   data spliced in at position I (default 0, the first parameter).
+   Return type and noexcept match C::f. C::f's cv qualifiers are applied
+   to the object and an && ref qualifier calls it on an rvalue object.
+   C-style variadic member functions can't be forwarded; compile error.
+
+   Static vtables
+   ==============
+   Signature-based type erasure without virtual functions; an interface
+   is a list of methods, each a name Tag paired with a function type F
+   (which may be abominable, e.g. void(int) const noexcept):
+
+     method<Tag, F>          // an interface entry
+     vtable<method<Tag,F>...>// struct of function pointers, one per method
+     vtable_for<T, M...>     // constexpr vtable<M...> for model type T
+     vtable_select<M...>(vt) // vtable<M...> with a subset of vt's methods
+
+   Each vtable entry has the 'erased' function pointer type
+     R(*)(void cv*, P...) noexcept(X)  for F = R(P...) cv ref noexcept(X)
+   and calls Tag{}(self, p...) with self as a T cv& or T cv&& object as
+   F's cvref dictates, so Tag is a function object type that dispatches
+   to the model, customization point style. A noexcept method's Tag call
+   must be nothrow. Invokers are interned on the model's object reference
+   type, not on F, so a Tag's noexcept and & variants share one function
+   per model (its const and && variants don't; a Tag may overload them).
+   Tags and vtables are plain values; an object can hold a vtable_select
+   of its hot methods inline, for single-indirection calls, alongside a
+   pointer to its full vtable.
+
+   Dispatch tables
+   ===============
+   Jump-table visitation over a set of unary handler functions R(P_i):
+
+     dispatch_table<&h...>          // constexpr array of erased invokers
+     dispatch_table<&h...>::call(i, msg) // calls h_i with *msg as its P_i
+
+   Each handler must be a free, non-variadic function, taking a single
+   parameter, with the same return type R as all the other handlers.
+   The table's call is noexcept only if all handlers are noexcept.
+   The message pointer is void*, cast to P_i; an rvalue reference
+   parameter P_i&& is passed an rvalue, anything else an lvalue.
+
+   Message bus
+   ===========
+   Handler slots keyed by exact function type, qualifiers and noexcept
+   included, resolved at compile time; no name lookup, no downcast:
+
+     bus<F...>                // one slot per distinct function type F
+     bus.on<&f>()             // set free function f for f's type
+     bus.on<&C::f>(obj)       // set member C::f of obj for C::f's type
+     bus.call<F>(p...)        // call F's handler with F's exact P...
+
+   Each slot holds an object pointer and an erased invoker, as a vtable
+   entry does, so a free function type may have a member handler too.
+
+   A bus has one handler per type, so messages that share a signature
+   share a handler; N handlers need N distinct types, such as a message
+   struct per handler, void(Msg<I>&). Each slot is a base class, and
+   naming one is a lookup among all of them, so compile time grows with
+   the square of the number of types: with g++ 12, a call to each of 100
+   handlers compiles in about 2 s and of 1000 in about 3 min. A bus suits
+   tens to hundreds of message types, called at a cost of an indirect
+   call; for thousands, index a dispatch_table by a message number.
+
+   Memoization
+   ===========
+     memoize<&f>   // function pointer of f's exact type that caches f's
+                   // most recent call, arguments and result, per thread
+     memoize_lru<&f, N>         // caches N results per thread (64),
+                                // evicting the least recently used
+     memoize_sharded<&f, N, S>  // caches N results (1024) shared by all
+                                // threads, in S locked LRU shards (16)
+
+   The cache key is a tuple of f's decayed parameter values, compared
+   with ==, so a key of trivially copyable parameters is a flat struct.
+   LRU keys are hashed: a packed key, of values each with a unique object
+   representation (integers, pointers, enums and structs of these), as
+   bytes; any other key, e.g. with floating point or std::string values,
+   by combining each value's std::hash.
+   f must return non-void and take no reference to non-const parameter
+   (these indicate side effects so the function is not pure).
+   f must not return a reference, which could refer into the arguments
+   of an earlier call. A sharded cache calls f with no lock held, so
+   concurrent misses on one key may each call f. A call whose key or
+   result can't be cached, as copying it throws, calls f uncached. A
+   cached result is returned by copy; for noexcept f, a copy that
+   throws (e.g. bad_alloc copying a std::string) calls terminate.
+
+   Instrumentation
+   ===============
+     instrumented<&f, Tag>  // function of f's exact type that calls f
+                            // inside a scope bracketed by a Tag object
+     instrumented<&f>       // Tag latency_of<&f>, timing calls of f
+
+   For a member function &C::f the instrumented function is f's 'free
+   form' R(C cv& or C cv&&, P...) noexcept(X); the object, with C::f's
+   cvref qualifiers, is passed first. The hook class Tag provides
+
+     static bool enabled();   // when false, f is called directly, and
+     Tag(); ~Tag();           // else a Tag is constructed around the call
+
+   so, when disabled, the overhead is a single predictable branch.
+   The default Tag, latency_of<&f>, times each call by steady_clock into
+   a per-thread, lock-free histogram of f's latencies:
+
+     latency_of<&f>::enable(on)  // start, or stop, sampling calls of f
+     latency_of<&f>::merge()     // latency_histogram summing all threads
+     latency_of<&f>::reset()     // zero all threads' histograms
+     latency_histogram::write_csv(out)  // lower_ns,upper_ns,count rows
+
+   Histograms are log-linear, 16 linear buckets per power of two of ns,
+   so a bucket spans at most 6.25% of its latencies; quantile(q) reads
+   the bucket holding the q-th quantile. latency<Id> shares one set of
+   histograms between the functions instrumented with Tag latency<Id>.
+
+   Call batching
+   =============
+     batching<F, BatchF, N>  // callable of signature F, void(P...), that
+                             // buffers P... into struct-of-arrays storage
+                             // and flushes batches of up to N to a BatchF
+
+   BatchF is called as batch(n, p0, p1, ...) with n the number of items
+   and pI a pointer to n values of the Ith decayed parameter type of F.
+   A flush happens when N items are buffered, on flush(), and on
+   destruction. F must return void. If F is noexcept then so must the
+   BatchF call be. Buffered parameter types must be default constructible.
+   A batch is taken out of the buffer before BatchF is called, so if the
+   call throws then that batch is dropped and the batching stays usable.
+   The destructor's flush is noexcept, as destructors are, so a BatchF
+   exception there terminates; flush() beforehand to handle exceptions.
+
+   Composition
+   ===========
+     compose<&f, &g, ...>  // function pointer to the fused pipeline
+                           // ...(g(f(p...))) with f's parameters P...
+
+   Each stage after the first must take a single parameter (or, for a
+   member function, no parameter; the previous result is its object),
+   to which the previous stage's return type must convert.
+   The fused function is noexcept when every stage is noexcept, returns
+   the last stage's return type and moves intermediates between stages,
+   except to a stage taking an lvalue, such as a const& member function,
+   which is passed the intermediate as an lvalue.
+
+   Packed arguments
+   ================
+     packed_args<F>       // storage for the decayed parameter values of F
+                          // laid out in decreasing alignment order
+     packed_args<F>::slot(i)   // storage position of parameter index i
+     get<I>()             // the value of parameter I, declaration order
+     apply(g)             // g(get<0>(), get<1>(), ...) as lvalues, or as
+                          // rvalues if F has && ref qualifier, one-shot
+
+   E.g. void(char, double, char, long long) packs into 18 bytes plus
+   tail padding rather than the 32 of a tuple in declaration order.
+
+   Partial application
+   ===================
+     bind_front<&f>(b...)  // closure with a non-template operator() of
+                           // f's residual signature R(Q...) noexcept(X)
+                           // for f's parameters P... = B..., Q...
+
+   For a member function &C::f the object is the first bound argument.
+   Bound values are stored decayed, each in a leaf class, of which an
+   empty class type is a base that takes no space (on MSVC too, as
+   empty_bases); std::ref(x) binds x by reference (as std::bind_front).
+   The operator() is qualified according to the bound parameter types:
+     const   if all bound parameters take const lvalues
+     &       if a bound parameter is a non-const lvalue reference
+     &&      if a bound parameter is an rvalue reference, so that e.g.
+             an && qualified member function is called on a moved object
+
+   Inline function storage
+   =======================
+     inline_function<F, Bytes>  // move-only owner of a callable of free
+                                // function type F stored in Bytes inline,
+                                // never allocating; e.g. a task slot
+
+   operator() has exactly F's parameters, return type and noexcept.
+   A callable too big for the slot, or not nothrow move constructible,
+   is not accepted; the constructor is constrained, so is_constructible
+   is false for it. Nor is a callable whose call might throw when F is
+   noexcept; then no exception capture is needed - e.g. a void() noexcept
+   task needs no promise.
+   The erased call, move and destroy operations are interned on F's
+   function_signature_t and the stored type, not on noexcept or Bytes,
+   so e.g. inline_function<void(int)> and <void(int) noexcept, 64> with
+   the same callable type share one operations table and its code.
+   target<D>() returns the stored callable if it is a D, as std::function.
+
+   Polymorphic values
+   ==================
+     poly<vtable<M...>, Bytes, vtable<H...>>  // move-only owner of a model
+                                // of interface M..., stored in Bytes inline,
+                                // with hot methods H... held in the object
+     p.call<Tag>(a...)          // calls method Tag on the stored model
+
+   A poly holds its model in inline storage, as inline_function does, a
+   pointer to the model's constexpr vtable_for, extended with its move and
+   destroy, and a vtable_select of the hot methods H..., a subset of M...
+   A hot method call is a single indirection, through the entry inside
+   the object; other calls load the vtable pointer first. No model type
+   has a vptr or RTTI; a model too big for Bytes, or not nothrow move
+   constructible, is not accepted. call on a const poly passes void const*
+   so only const qualified methods can be called.
+
+   Callback awaitables
+   ===================
+   Async operations of shape  void op(A..., Callback cb)  report results
+   R... through a call cb(R...) of the trailing callback parameter:
+
+     callback_result_t<&op>   // type of the results, by decay, as void,
+                              // the single R, or std::tuple<R...>
+     awaitable_from<&op>(a...)// (C++20) an awaitable for op(a..., cb)
+
+   The callback's function type is found from function_arg_types of op:
+   a function pointer's pointee, or the type of a class operator() such
+   as inline_function's. The awaitable holds the arguments and result,
+   so its state lives in the awaiting coroutine's frame; with a callback
+   class of inline storage, like inline_function, nothing is allocated.
+   A callback called before op returns completes the co_await without
+   suspension; a later callback resumes the coroutine inside its call.
+   The callback is constructed from a lambda holding the awaitable's
+   address, so a plain function pointer callback is a compile error.
+
+     frame_arena<Bytes>       // (C++20) coroutine frames from a buffer
+     arena_frames<Arena>      // promise_type base: frames from an Arena&
+
+   The frame of the awaiting coroutine itself is the promise type's to
+   allocate. A promise_type derived from arena_frames<Arena> takes its
+   frames from the Arena& that the coroutine is passed first (second,
+   after the object, for a member coroutine); a pointer to the arena is
+   kept before each frame for its release. frame_arena<Bytes> is such an
+   arena, for one thread: frames bump an offset into its buffer, which is
+   reused once all are freed; frames that don't fit come from operator
+   new. Any class with allocate(n) and deallocate(p, n) may be an Arena.
+
+   Exception boundaries
+   ====================
+     nothrow<&f, &on_error>  // noexcept function of f's parameters that
+                             // returns X, on_error's return type
+
+   On success the X result is constructed from f's result (or value
+   initialized for void f). On an exception, on_error() is called from
+   the catch block, so it may rethrow within its own try to map the
+   exception, e.g. to a std::optional<R>, error code or expected-like X.
+   on_error must be noexcept. If f is noexcept and X is nothrow
+   constructible from f's result then no try block is generated at all.
+   For a member function &C::f the function is f's 'free form'.
+
+   Signature conversion
+   ====================
+     function_convert<To, &f>  // &f itself, as To* or To C::*, when f's
+                               // type is call compatible with To, else
+                               // a thunk of type To* that calls f
+
+   Call compatibility is function_is_call_compatible_v<F, To>; i.e. a
+   function's pointer is stored as is where only noexcept is dropped.
+   Otherwise To must be a free function type whose parameters can be
+   passed on to f (the object first for &C::f) and whose return type
+   f's result converts to. A noexcept To requires a noexcept f.
+
+   Parameter passing
+   =================
+     optimal_params<&f>  // function of type function_optimal_params_t<F>
+                         // for f's type F (free form for &C::f) calling f
+
+   Small trivially copyable parameters taken by const& are taken by
+   value, to be passed in registers, and large or non-trivial by-value
+   parameters by const&, so that f's copy is made at the inner call.
+   The object parameter of the free form of &C::f is left as is.
+
+   Lane-batched mapping
+   ====================
+     simd_map<&f, W>  // function void(size_t n, R* out, P const*... in)
+                      // setting out[i] = f(in[i]...) for i < n
+     simd_isa()       // "avx512f", "avx2" or "baseline", the ISA used
+
+   for a free function f of type R(P...) with arithmetic R and P...;
+   anything else is a compile error. Elements are processed in blocks
+   of W lanes as fixed trip count inner loops, which the compiler's
+   vectorizer turns into vector instructions when f is inlinable (at
+   -O2 from GCC 12, else at -O3), with a scalar tail. W = 0, the default,
+   takes as many lanes as one vector holds of the widest of R and P...
+   On x86 with GCC or Clang the loop is compiled three times: for AVX-512F
+   and AVX2, by target attributes, and for the compiler's baseline target
+   (SSE2 unless flags say more). The first call picks the widest clone
+   the CPU supports, by __builtin_cpu_supports. Elsewhere, and with MSVC,
+   only the baseline loop is built. An f that can't be inlined (defined
+   in another translation unit, or marked noinline) runs one scalar call
+   per element in any clone.
+
+   Parallel apply
+   ==============
+     parallel_apply<&f>(range)     // f(x) for each element x of range
+     parallel_apply<&f>(in, out)   // out[i] = f(in[i]), out sized as in
+     parallel_apply<&f>(ex, ...)   // either, run on executor ex
+
+   for a noexcept free function f of one parameter P; a potentially
+   throwing f is a compile error, so no exception is ever captured and
+   moved between threads. Elements are passed as P dictates: P&& moves
+   the element, P& or P const& binds it, a value P copies it.
+   Ranges are contiguous, as given by std::data and std::size.
+
+   The caller and up to one task per worker of an executor, ex or else
+   one shared, made on first use with a worker per hardware thread but
+   one, claim chunks from an atomic counter; the threads persist between
+   calls. Chunks are split at 64 byte aligned addresses of the output (of
+   the range itself for the one argument form), so that no two threads
+   write the same cache line when elements tile lines; the first chunk
+   starts at the first element and ends at a line boundary. The caller
+   joins the tasks by executor::wait_until, running other tasks meanwhile,
+   so f may itself call parallel_apply. The caller carries on alone if
+   the executor can't be started or a task can't be queued.
+
+   Invocation
+   ==========
+     invoke(f, a...)     // std::invoke(f, a...) in a single, force-inlined
+     invoke_r<R>(f, a...)// call frame; invoke_r converts the result to R
+
+   Member pointers F C::* are applied to an object, in the value category
+   given, or to what a pointer, smart pointer or std::reference_wrapper
+   refers to. Unlike std::invoke, an && qualified member function called
+   via a pointer is called on the object as an rvalue. Inlining is forced
+   by gnu::always_inline (or MSVC __forceinline), and arguments are
+   forwarded by static_cast rather than std::forward, so that debug and
+   -Og builds call the target directly, with no layers between.
+
+   Varargs forwarding
+   ==================
+     variadic_forwarder<&f, &vf>  // function of f's C-variadic type F
+                                  // (free form for &C::f) that passes
+                                  // its va_list on to vf
+
+   vf is the 'v' variant of f, of type function_valist_t<F>, or of the
+   member form of that type for &C::vf (a noexcept vf may serve a non
+   noexcept f). The forwarder is what f is often written by hand to be:
+   va_start, a call of vf with the arguments and va_list, then va_end,
+   with no intermediate buffer. f itself is never called; it gives the
+   signature, so it may be declared and left undefined. The parameter
+   before the ellipsis must not be a reference, nor of a type changed by
+   default argument promotion (float, bool, char or short types), as
+   va_start requires.
+
+   Call recording
+   ==============
+     call_record<F>      // a steady clock time, in ns, and packed_args<F>
+     call_recorder<F, N> // appends call_records of its calls to a log,
+                         // buffering N records before each write
+     call_recorder<F, N>::write_header(log)  // starts a log stream
+     call_replayer<F>    // reads the log back, calling a handler with the
+                         // recorded arguments, timed or at full speed
+
+   F's decayed parameter types must be trivially copyable and default
+   constructible, so records are flat bytes. The log is a std::FILE*
+   stream of a header, with a hash of F's signature layout and the
+   record size, followed by the records. The hash is computed from the
+   sizes, alignments and kinds of F's types with its qualifier flags,
+   so it is stable across builds for the same ABI, and a replayer
+   refuses a log of another layout.
+
+   The header is written once, by write_header, before any recorder on
+   the stream flushes. A recorder is used by one thread; give each thread
+   its own recorder on a shared stream. Its calls only copy to its buffer;
+   the stream is written a whole buffer at a time (stdio locks the stream
+   per write), so records of different threads interleave by buffers.
+   Recording takes no lock only while each thread has its own recorder;
+   a recorder shared between threads is a data race. The log is not
+   memory mapped: it is written and read by stdio, record by record.
+
+   Call site caching
+   =================
+     cached_call_site<F, D...>  // an inline_function of signature F with
+                                // an inline cache of known target types
+
+   operator() has exactly F's parameters, return type and noexcept.
+   It compares the stored callable's operations table against those of
+   the known callable types D..., in order, and on a hit calls the D
+   directly, a call the compiler can inline; on a miss it makes the
+   erased call. One D makes a monomorphic cache, a few a polymorphic one;
+   other types still work, at the cost of the compares. Counters of the
+   hits per D and of the misses report the cache's hit rate; they are
+   plain counters, so a call site object is for use by one thread.
+
+   Hot swappable slots
+   ===================
+     hot_slot<F>        // an atomic function pointer, of the free form
+                        // of F; function_signature_t<F> with F's noexcept
+     hot_slot<F, true>  // the same, also counting calls in flight so that
+                        // synchronize() can wait out a grace period
+
+   operator() has exactly F's parameters, return type and noexcept; it
+   is an acquire load of the pointer and an indirect call, with no lock.
+   swap(f) installs f and returns the previous function, so a new
+   implementation's data published before the swap is visible to calls
+   through it. Calls already in flight may still be in the old function.
+
+   hot_slot<F, true> lets the old function's resources be reclaimed: after
+   swap(f), synchronize() returns only once every call that could have
+   loaded a previous function has returned. Calls are counted on two
+   epoch counters, as in userspace RCU, at the cost of two atomic
+   increments of a shared count per call; synchronize() blocks, so it
+   must not be called from within a call through the slot.
+
+   Executor
+   ========
+     executor ex{n}           // n worker threads (default: one per core)
+     ex.submit(f, a...)       // runs f(a...) on a worker; returns void if
+                              // f is noexcept and returns void, else an
+                              // executor::result<R> if f is noexcept,
+                              // else a std::future of f's return type R
+     ex.wait()                // runs tasks until all submitted are done
+     ex.wait_until(done)      // runs tasks until done() returns true
+
+   f's signature S is found by function_traits from the callable type:
+   a function pointer's pointee, a member function pointer's member type
+   (with the object as the first argument a...) or the type of a class's
+   single operator(). R is function_return_type_t<S>. Every task is an
+   inline_function<void() noexcept> of executor::task_bytes, holding f
+   and the decayed arguments. When function_is_noexcept_v<S> (and the
+   arguments pass to f nothrow) the task calls f directly, with no
+   exception capture, and allocates nothing: a void task has no result
+   at all, so join it by wait or a counter of your own, and any other
+   writes R in place into the executor::result<R> returned by submit.
+   That result can't be copied or moved, as the task holds its address;
+   get() waits, running other tasks meanwhile, and returns R, left in the
+   slot; the destructor waits too. Otherwise the task catches into a
+   std::promise<R>, whose shared state std::promise allocates on the heap.
+   std::reference_wrapper arguments are passed on as references.
+
+   Each worker owns a deque of tasks, guarded by its own lock; it pushes
+   and pops its own tasks at the back, LIFO, and when empty steals from
+   the front of the others' deques, FIFO. Tasks submitted from outside
+   the pool are dealt round robin. Idle workers sleep; a submit wakes one
+   only if any sleep. wait() may not be called from a task, as the task
+   itself is pending; a task forking subtasks joins them by wait_until
+   on a counter, running other tasks meanwhile. The destructor waits.
+*/
+
+namespace ltl
+{
+namespace impl
+{
+// member_function<MFP>
+// The class type C and function type F of member function pointer F C::*
+template <typename MFP> struct member_function;
+
+template <typename F, class C> struct member_function<F C::*>
+{
+  static_assert(std::is_function_v<F>,
+                "member_function<F C::*> requires a member function pointer");
+  using class_type = C;
+  using type = F;
+};
+
+// object_cv_t<C,F> class C with the cv qualifiers of function type F
+template <class C, typename F>
+using object_cv_t = std::conditional_t<function_is_const_v<F>,
+                      std::conditional_t<function_is_volatile_v<F>,
+                                         C const volatile, C const>,
+                      std::conditional_t<function_is_volatile_v<F>,
+                                         C volatile, C>>;
+
+// object_t<C,F> type of the implicit object argument for calling a member
+// function of type F on class C; C cv& or C cv&& as the F cvref dictates
+template <class C, typename F>
+using object_t = std::conditional_t<function_is_reference_rvalue_v<F>,
+                                    object_cv_t<C,F>&&, object_cv_t<C,F>&>;
+
+// split_at<I, arg_types<>, arg_types<P...>>
+// Splits a type-list P... into 'head' of the first I types and 'tail' rest.
+template <typename Head, typename Tail>
+struct head_tail { using head = Head; using tail = Tail; };
+
+template <std::size_t I, typename Head, typename Tail>
+struct split_at : head_tail<Head, Tail>
+{
+  static_assert(I == 0, "split_at index is out of range");
+};
+template <std::size_t I, typename... H, typename T0, typename... T>
+struct split_at<I, arg_types<H...>, arg_types<T0, T...>>
+  : std::conditional_t<I == 0,
+                       head_tail<arg_types<H...>, arg_types<T0, T...>>,
+                       split_at<I - 1, arg_types<H..., T0>, arg_types<T...>>>
+{};
+
+// callee<&f> the 'free form' of a function or member function pointer;
+// type F for &f of type F*, or for &C::f of type F C::* the free function
+// type R(O, P...) noexcept(X) with O = object_t<C,F> the object parameter
+template <auto f, typename FP = decltype(f)>
+struct callee
+{
+  static_assert(is_free_function_v<std::remove_pointer_t<FP>>,
+                "callee requires a function or member function pointer");
+  using type = std::remove_pointer_t<FP>;
+
+  template <typename... A>
+  static decltype(auto) invoke(A&&... a)
+                        noexcept(function_is_noexcept_v<type>)
+  {
+    return f(std::forward<A>(a)...);
+  }
+};
+
+template <auto f, typename F, class C>
+struct callee<f, F C::*>
+{
+  template <typename... P>
+  using object_first = function_return_type_t<F>(object_t<C,F>, P...)
+                                         noexcept(function_is_noexcept_v<F>);
+  using type = function_set_variadic_t<function_arg_types<F, object_first>,
+                                       function_is_variadic_v<F>>;
+
+  template <typename O, typename... A>
+  static decltype(auto) invoke(O&& o, A&&... a)
+                        noexcept(function_is_noexcept_v<F>)
+  {
+    return (std::forward<O>(o).*f)(std::forward<A>(a)...);
+  }
+};
+
+template <auto mf, typename Head, typename Tail> struct c_thunk;
+
+template <auto mf, typename... H, typename... T>
+struct c_thunk<mf, arg_types<H...>, arg_types<T...>>
+{
+  using C = typename member_function<decltype(mf)>::class_type;
+  using F = typename member_function<decltype(mf)>::type;
+
+  static function_return_type_t<F> call(H... h, void* user, T... t)
+                                            noexcept(function_is_noexcept_v<F>)
+  {
+    return (static_cast<object_t<C,F>>(
+              *static_cast<object_cv_t<C,F>*>(user)).*mf)(
+                std::forward<H>(h)..., std::forward<T>(t)...);
+  }
+};
+
+template <auto mf, std::size_t I>
+constexpr auto make_c_thunk()
+{
+  using F = typename member_function<decltype(mf)>::type;
+  static_assert(!function_is_variadic_v<F>,
+                "c_thunk: C varargs can't be forwarded");
+  using args = split_at<I, arg_types<>, function_arg_types<F>>;
+  return &c_thunk<mf, typename args::head, typename args::tail>::call;
+}
+} // namespace impl
+
+// c_thunk<&C::f, I> a C callback function pointer R(*)(P..., void*, P...)
+// with void* user data at parameter index I that calls C::f on the object
+template <auto mf, std::size_t I = 0>
+inline constexpr auto c_thunk = impl::make_c_thunk<mf, I>();
+
+// c_thunk_for<L, I> a C callback function pointer for lambda type L
+template <class L, std::size_t I = 0>
+inline constexpr auto c_thunk_for = c_thunk<&L::operator(), I>;
+
+namespace impl
+{
+// erased_fn<F>::type<P...> = R(void cv*, P...) noexcept(X) for the
+// function type F = R(P...) cv ref noexcept(X); the vtable entry type
+template <typename F>
+struct erased_fn
+{
+  static_assert(!function_is_variadic_v<F>,
+                "vtable: C varargs can't be forwarded");
+  template <typename... P>
+  using type = function_return_type_t<F>(object_cv_t<void,F>*, P...)
+                                         noexcept(function_is_noexcept_v<F>);
+};
+template <typename F>
+using erased_fn_t = function_arg_types<F, erased_fn<F>::template type>;
+
+// erased_call<Tag, R, O, V, P...> the erased invoker calling Tag{}(o, p...)
+// with o, of object reference type O, cast from self of type V*, noexcept
+// as the Tag call is. It is interned on O rather than on F, so that F's
+// noexcept variants, and its unqualified and & variants, share one call;
+// const, volatile and && variants differ in O, as a Tag may overload on them
+template <class Tag, typename R, class O, typename V, typename... P>
+struct erased_call
+{
+  static R call(V* self, P... p)
+                       noexcept(std::is_nothrow_invocable_r_v<R, Tag, O, P...>)
+  {
+    return Tag{}(static_cast<O>(
+                   *static_cast<std::remove_reference_t<O>*>(self)),
+                 std::forward<P>(p)...);
+  }
+};
+
+// erased<T, Tag, F>::call the erased invoker of method Tag of type F for
+// model type T; a noexcept F requires a nothrow Tag call
+template <class T, class Tag, typename F, typename = function_arg_types<F>>
+struct erased;
+
+template <class T, class Tag, typename F, typename... P>
+struct erased<T, Tag, F, arg_types<P...>>
+  : erased_call<Tag, function_return_type_t<F>, object_t<T,F>,
+                object_cv_t<void,F>, P...>
+{
+  static_assert(!function_is_noexcept_v<F>
+             || std::is_nothrow_invocable_r_v<function_return_type_t<F>, Tag,
+                                              object_t<T,F>, P...>,
+                "vtable: the Tag call of a noexcept method may throw");
+};
+
+// vtable_slot<Tag,F> a vtable base class holding the entry for one method
+template <class Tag, typename F>
+struct vtable_slot
+{
+  erased_fn_t<F>* fn;
+};
+
+template <class Tag, typename F>
+constexpr auto get_slot(vtable_slot<Tag,F> const& slot) { return slot.fn; }
+} // namespace impl
+
+// method<Tag,F> an interface entry: a name Tag paired with function type F
+template <class Tag, typename F>
+struct method
+{
+  using tag = Tag;
+  using type = F;
+};
+
+// vtable<method<Tag,F>...> an aggregate of typed function pointers
+template <class... M>
+struct vtable : impl::vtable_slot<typename M::tag, typename M::type>...
+{
+  // get<Tag>() returns the entry for method Tag; R(*)(void cv*, P...)
+  template <class Tag>
+  constexpr auto get() const { return impl::get_slot<Tag>(*this); }
+};
+
+// vtable_for<T, method<Tag,F>...> the constexpr vtable for model type T
+template <class T, class... M>
+inline constexpr vtable<M...> vtable_for{
+  impl::vtable_slot<typename M::tag, typename M::type>{
+    &impl::erased<T, typename M::tag, typename M::type>::call}...};
+
+// vtable_select<M...>(vt) a vtable with a subset M... of vt's methods
+template <class... M, class... V>
+constexpr vtable<M...> vtable_select(vtable<V...> const& vt)
+{
+  return {impl::vtable_slot<typename M::tag, typename M::type>{
+            vt.template get<typename M::tag>()}...};
+}
+
+namespace impl
+{
+// unary_handler<H> checks handler pointer type H = F*, F a function R(P),
+// giving its return type R and 'arg' the reference type to cast msg to
+template <typename H,
+          typename F = std::remove_pointer_t<H>,
+          typename = function_arg_types<F>>
+struct unary_handler
+{
+  static_assert(!sizeof(H*),
+        "dispatch_table: handlers must be unary, non-variadic free functions");
+};
+template <typename H, typename F, typename P>
+struct unary_handler<H, F, arg_types<P>>
+{
+  static_assert(std::is_pointer_v<H> && !function_is_variadic_v<F>,
+        "dispatch_table: handlers must be unary, non-variadic free functions");
+  using return_type = function_return_type_t<F>;
+  using arg = std::conditional_t<std::is_rvalue_reference_v<P>,
+                                 P, std::remove_reference_t<P>&>;
+};
+
+template <auto h, bool nx>
+auto dispatch_invoke(void* msg) noexcept(nx)
+  -> typename unary_handler<decltype(h)>::return_type
+{
+  using P = typename unary_handler<decltype(h)>::arg;
+  return h(static_cast<P>(*static_cast<std::remove_reference_t<P>*>(msg)));
+}
+
+template <typename R, typename... Rs>
+constexpr bool all_same_v = (std::is_same_v<R, Rs> && ...);
+
+// first<T, Ts...>::type the first type of a pack
+template <typename T, typename...> struct first { using type = T; };
+} // namespace impl
+
+// dispatch_table<&h...> a dense jump table of unary handler functions
+template <auto... h>
+struct dispatch_table
+{
+  // the first handler's, rather than a common type, which may not exist
+  // when the return types differ, failing before the static_assert
+  using return_type = typename impl::first<
+           typename impl::unary_handler<decltype(h)>::return_type...>::type;
+
+  static_assert(impl::all_same_v<return_type,
+                   typename impl::unary_handler<decltype(h)>::return_type...>,
+                "dispatch_table: handlers must have the same return type");
+
+  static constexpr bool is_noexcept =
+        (function_is_noexcept_v<std::remove_pointer_t<decltype(h)>> && ...);
+
+  using invoker = return_type(void*) noexcept(is_noexcept);
+
+  static constexpr std::size_t size = sizeof...(h);
+
+  static constexpr invoker* table[sizeof...(h)] = {
+                            &impl::dispatch_invoke<h, is_noexcept>... };
+
+  // call(i, msg) invokes handler h_i on message *msg; requires i < size
+  static return_type call(std::size_t i, void* msg) noexcept(is_noexcept)
+  {
+    return table[i](msg);
+  }
+};
+
+namespace impl
+{
+// member_call<&C::f> a function object type calling member f on its first
+// argument; a vtable method Tag for an erased member function call
+template <auto mf>
+struct member_call
+{
+  template <class O, typename... A>
+  decltype(auto) operator()(O&& o, A&&... a) const
+                 noexcept(noexcept((std::forward<O>(o).*mf)(
+                                                   std::forward<A>(a)...)))
+  {
+    return (std::forward<O>(o).*mf)(std::forward<A>(a)...);
+  }
+};
+
+// erased_free<&f> an erased invoker that calls free function f, ignoring
+// its self parameter; R(void*, P...) for f's type R(P...) noexcept(X)
+template <auto f, typename F = std::remove_pointer_t<decltype(f)>,
+          typename = function_arg_types<F>>
+struct erased_free;
+
+template <auto f, typename F, typename... P>
+struct erased_free<f, F, arg_types<P...>>
+{
+  static function_return_type_t<F> call(void*, P... p)
+                                            noexcept(function_is_noexcept_v<F>)
+  {
+    return f(std::forward<P>(p)...);
+  }
+};
+
+// bus_slot<F> an object pointer and erased invoker, as a vtable entry
+template <typename F, typename = function_arg_types<F>> struct bus_slot;
+
+template <typename F, typename... P>
+struct bus_slot<F, arg_types<P...>>
+{
+  object_cv_t<void,F>* self = nullptr;
+  erased_fn_t<F>* fn = nullptr;
+
+  function_return_type_t<F> operator()(P... p) const
+                                            noexcept(function_is_noexcept_v<F>)
+  {
+    return fn(self, std::forward<P>(p)...);
+  }
+};
+} // namespace impl
+
+// bus<F...> handler slots keyed by exact, distinct, function types F...
+template <typename... F>
+class bus : impl::bus_slot<F>...
+{
+  template <typename G> using slot = impl::bus_slot<G>;
+
+ public:
+  // on<&f>() sets free function f as the handler for its type
+  template <auto f, typename G = std::remove_pointer_t<decltype(f)>>
+  void on() noexcept
+  {
+    static_assert(is_free_function_v<G>, "bus: on<&f>() takes a function");
+    slot<G>::fn = &impl::erased_free<f>::call;
+  }
+
+  // on<&C::f>(obj) sets member C::f of obj as the handler for its type
+  template <auto mf,
+            class C = typename impl::member_function<decltype(mf)>::class_type,
+            typename G = typename impl::member_function<decltype(mf)>::type>
+  void on(impl::object_cv_t<C,G>& obj) noexcept
+  {
+    slot<G>::self = &obj;
+    slot<G>::fn = &impl::erased<C, impl::member_call<mf>, G>::call;
+  }
+
+  // on<&C::f>(rvalue) is deleted; the handler object must outlive the bus
+  template <auto mf,
+            class C = typename impl::member_function<decltype(mf)>::class_type,
+            typename G = typename impl::member_function<decltype(mf)>::type>
+  void on(impl::object_cv_t<C,G>&& obj) = delete;
+
+  // has<G>() returns true if a handler is set for type G
+  template <typename G>
+  bool has() const noexcept { return slot<G>::fn != nullptr; }
+
+  // call<G>(p...) calls the handler for type G; requires has<G>()
+  template <typename G, typename... A>
+  decltype(auto) call(A&&... a) const noexcept(function_is_noexcept_v<G>)
+  {
+    return static_cast<slot<G> const&>(*this)(std::forward<A>(a)...);
+  }
+};
+
+namespace impl
+{
+// memo_result<R> true if a result of type R can be cached: a value, not
+// void, nor a reference, which could refer into an earlier call's args
+template <typename R>
+inline constexpr bool memo_result = !std::is_void_v<R>
+                                 && !std::is_reference_v<R>;
+
+template <auto f, typename F = std::remove_pointer_t<decltype(f)>,
+          typename = function_arg_types<F>>
+struct memoized;
+
+template <auto f, typename F, typename... P>
+struct memoized<f, F, arg_types<P...>>
+{
+  using R = function_return_type_t<F>;
+  static_assert(is_free_function_v<F> && !function_is_variadic_v<F>,
+                "memoize: requires a non-variadic free function");
+  static_assert(memo_result<R>, "memoize: void or reference return type");
+  static_assert(((!std::is_reference_v<P> ||
+                  std::is_const_v<std::remove_reference_t<P>>) && ...),
+                "memoize: parameter is a reference to non-const");
+
+  using key = std::tuple<std::decay_t<P>...>;
+
+  struct entry
+  {
+    key args;
+    R value;
+  };
+
+  // key_of(p...) a copy of p... as a cache key, or none if copying throws
+  static std::optional<key> key_of(P&... p) noexcept
+  {
+    try {
+      return key{p...};
+    }
+    catch (...) {
+      return std::nullopt;
+    }
+  }
+
+  static R call(P... p) noexcept(function_is_noexcept_v<F>)
+  {
+    thread_local std::optional<entry> last;
+    if (last && last->args == std::forward_as_tuple(p...))
+      return last->value;
+    R r = f(p...);
+    try {
+      last.emplace(entry{key{p...}, r});
+    }
+    catch (...) {} // left empty; r is returned uncached
+    return r;
+  }
+};
+} // namespace impl
+
+// memoize<&f> a function of f's type caching f's last result, per thread
+template <auto f>
+inline constexpr auto memoize = &impl::memoized<f>::call;
+
+namespace impl
+{
+// memo_hash<K> hashes a key tuple K of decayed parameter values; a packed
+// key, of values with unique object representations, hashes their bytes
+// (FNV-1a), any other key combines the std::hash of each value
+template <typename K> struct memo_hash;
+
+template <typename... K>
+struct memo_hash<std::tuple<K...>>
+{
+  static constexpr bool packed =
+                       (std::has_unique_object_representations_v<K> && ...);
+
+  std::size_t operator()(std::tuple<K...> const& k) const noexcept
+  {
+    std::uint64_t h = 14695981039346656037u;
+    std::apply([&h](K const&... v) {
+      if constexpr (packed) {
+        auto bytes = [&h](void const* p, std::size_t n) {
+          for (std::size_t i = 0; i != n; ++i)
+            h = (h ^ static_cast<unsigned char const*>(p)[i]) * 1099511628211u;
+        };
+        (bytes(&v, sizeof v), ...);
+      }
+      else
+        ((h = (h ^ std::hash<K>{}(v)) * 1099511628211u), ...);
+    }, k);
+    return std::size_t(h ^ h >> 32);
+  }
+};
+
+// memo_lru<K, R, N> a cache of up to N results R by key K, evicting the
+// least recently used
+template <typename K, typename R, std::size_t N>
+class memo_lru
+{
+  static_assert(N != 0, "memoize: cache size must be nonzero");
+
+  std::list<std::pair<K, R>> order; // most recently used first
+  std::unordered_map<K, typename decltype(order)::iterator, memo_hash<K>>
+                                                                      index;
+ public:
+  // find(k) the cached result for key k, now most recently used, or null
+  R const* find(K const& k) noexcept
+  {
+    auto i = index.find(k);
+    if (i == index.end())
+      return nullptr;
+    order.splice(order.begin(), order, i->second);
+    return &i->second->second;
+  }
+
+  // insert(k, r) caches r for k, first evicting the least recently used
+  // result when full; on failure to allocate, r is just not cached
+  void insert(K&& k, R const& r) noexcept
+  {
+    try {
+      if (index.size() == N) {
+        index.erase(order.back().first);
+        order.pop_back();
+      }
+      order.emplace_front(std::move(k), r);
+      try {
+        index.emplace(order.front().first, order.begin());
+      }
+      catch (...) {
+        order.pop_front();
+      }
+    }
+    catch (...) {}
+  }
+};
+
+template <auto f, std::size_t N, std::size_t S,
+          typename F = std::remove_pointer_t<decltype(f)>,
+          typename = function_arg_types<F>>
+struct memoized_lru;
+
+template <auto f, std::size_t N, std::size_t S, typename F, typename... P>
+struct memoized_lru<f, N, S, F, arg_types<P...>> : memoized<f>
+{
+  using typename memoized<f>::R;
+  using typename memoized<f>::key;
+  using memoized<f>::key_of;
+  static_assert(S != 0, "memoize_sharded: shard count must be nonzero");
+
+  // call(p...) f(p...) from a per-thread LRU cache of N results
+  static R call(P... p) noexcept(function_is_noexcept_v<F>)
+  {
+    thread_local memo_lru<key, R, N> cache;
+    std::optional<key> k = key_of(p...);
+    if (!k)
+      return f(p...);
+    if (R const* r = cache.find(*k))
+      return *r;
+    R r = f(p...);
+    cache.insert(std::move(*k), r);
+    return r;
+  }
+
+  // shard a locked LRU cache of N / S results, on its own cache lines
+  struct alignas(64) shard
+  {
+    std::mutex m;
+    memo_lru<key, R, (N + S - 1) / S> cache;
+  };
+
+  // shared(p...) f(p...) from S locked LRU caches shared by all threads,
+  // selected by key hash; f is called with no lock held
+  static R shared(P... p) noexcept(function_is_noexcept_v<F>)
+  {
+    static shard shards[S];
+    std::optional<key> k = key_of(p...);
+    if (!k)
+      return f(p...);
+    shard& s = shards[memo_hash<key>{}(*k) % S];
+    {
+      std::lock_guard<std::mutex> lock{s.m};
+      if (R const* r = s.cache.find(*k))
+        return *r;
+    }
+    R r = f(p...);
+    std::lock_guard<std::mutex> lock{s.m};
+    s.cache.insert(std::move(*k), r);
+    return r;
+  }
+};
+} // namespace impl
+
+// memoize_lru<&f, N> a function of f's type caching f's N most recently
+// used results, per thread
+template <auto f, std::size_t N = 64>
+inline constexpr auto memoize_lru = &impl::memoized_lru<f, N, 1>::call;
+
+// memoize_sharded<&f, N, S> a function of f's type caching up to N
+// results shared by all threads, in S independently locked LRU shards
+template <auto f, std::size_t N = 1024, std::size_t S = 16>
+inline constexpr auto memoize_sharded = &impl::memoized_lru<f, N, S>::shared;
+
+namespace impl
+{
+template <auto f, class Tag, typename F = typename callee<f>::type,
+          typename = function_arg_types<F>>
+struct instrument;
+
+template <auto f, class Tag, typename F, typename... P>
+struct instrument<f, Tag, F, arg_types<P...>>
+{
+  static_assert(!function_is_variadic_v<F>,
+                "instrumented: C varargs can't be forwarded");
+
+  static function_return_type_t<F> call(P... p)
+                                            noexcept(function_is_noexcept_v<F>)
+  {
+    if (!Tag::enabled())
+      return callee<f>::invoke(std::forward<P>(p)...);
+    Tag scope;
+    return callee<f>::invoke(std::forward<P>(p)...);
+  }
+};
+} // namespace impl
+
+// latency_histogram a log-linear histogram of nanosecond latencies; exact
+// below 16 ns then 16 linear sub-buckets per power of two (6.25% wide)
+class latency_histogram
+{
+  static constexpr unsigned log2(std::uint64_t v) noexcept
+  {
+    unsigned e = 0;
+    for (unsigned s = 32; s != 0; s /= 2)
+      if (v >> s) {
+        v >>= s;
+        e += s;
+      }
+    return e;
+  }
+
+ public:
+  static constexpr std::size_t buckets = 61 * 16;
+
+  // bucket(ns) the index of the bucket counting latency ns
+  static constexpr std::size_t bucket(std::uint64_t ns) noexcept
+  {
+    if (ns < 16)
+      return std::size_t(ns);
+    unsigned e = log2(ns);
+    return (e - 3) * 16 + (ns >> (e - 4) & 15);
+  }
+
+  // lower(i) the least latency counted in bucket i, upper(i) the greatest
+  static constexpr std::uint64_t lower(std::size_t i) noexcept
+  {
+    return i < 16 ? i : (16 + i % 16) << (i / 16 - 1);
+  }
+  static constexpr std::uint64_t upper(std::size_t i) noexcept
+  {
+    return i < 16 ? i : lower(i) + (std::uint64_t{1} << (i / 16 - 1)) - 1;
+  }
+
+  std::uint64_t counts[buckets] = {};
+
+  // add(ns, n) counts n latencies of ns
+  void add(std::uint64_t ns, std::uint64_t n = 1) noexcept
+  {
+    counts[bucket(ns)] += n;
+  }
+
+  latency_histogram& operator+=(latency_histogram const& h) noexcept
+  {
+    for (std::size_t i = 0; i != buckets; ++i)
+      counts[i] += h.counts[i];
+    return *this;
+  }
+
+  // total() the number of latencies counted
+  std::uint64_t total() const noexcept
+  {
+    std::uint64_t n = 0;
+    for (std::uint64_t c : counts)
+      n += c;
+    return n;
+  }
+
+  // quantile(q) the upper bound of the bucket of the q-th quantile, or 0
+  // if empty
+  std::uint64_t quantile(double q) const noexcept
+  {
+    std::uint64_t n = total();
+    if (n == 0)
+      return 0;
+    auto rank = std::min(n - 1, std::uint64_t(q * double(n)));
+    std::size_t i = 0;
+    for (; counts[i] <= rank; ++i)
+      rank -= counts[i];
+    return upper(i);
+  }
+
+  // write_csv(out) writes a CSV row lower_ns,upper_ns,count for each
+  // non-empty bucket, after a header row
+  void write_csv(std::FILE* out) const noexcept
+  {
+    std::fprintf(out, "lower_ns,upper_ns,count\n");
+    for (std::size_t i = 0; i != buckets; ++i)
+      if (counts[i] != 0)
+        std::fprintf(out, "%llu,%llu,%llu\n",
+                     static_cast<unsigned long long>(lower(i)),
+                     static_cast<unsigned long long>(upper(i)),
+                     static_cast<unsigned long long>(counts[i]));
+  }
+};
+
+namespace impl
+{
+// latency_shard a thread's histogram, written by its claiming thread only
+// and read by any thread; shards are listed, never freed, and reclaimed
+// by later threads once their thread exits
+struct latency_shard
+{
+  std::atomic<std::uint64_t> counts[latency_histogram::buckets] = {};
+  std::atomic<bool> claimed{true};
+  latency_shard* next = nullptr;
+
+  void add(std::uint64_t ns) noexcept
+  {
+    auto& c = counts[latency_histogram::bucket(ns)];
+    c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+};
+} // namespace impl
+
+// latency<Id> an instrumented Tag timing each call into a per-thread
+// latency histogram; the histograms of all threads are merged on demand
+template <class Id = void>
+class latency
+{
+  using clock_type = std::chrono::steady_clock;
+
+  static inline std::atomic<bool> on{false};
+  static inline std::atomic<impl::latency_shard*> shards{nullptr};
+
+  // local() this thread's shard, claimed on first use, or null if none
+  // could be allocated
+  static impl::latency_shard* local() noexcept
+  {
+    struct claim
+    {
+      impl::latency_shard* shard = nullptr;
+      claim() noexcept
+      {
+        for (auto s = shards.load(std::memory_order_acquire); s; s = s->next)
+          if (!s->claimed.load(std::memory_order_relaxed)
+              && !s->claimed.exchange(true, std::memory_order_acquire)) {
+            shard = s;
+            return;
+          }
+        shard = new (std::nothrow) impl::latency_shard;
+        if (shard) {
+          shard->next = shards.load(std::memory_order_relaxed);
+          while (!shards.compare_exchange_weak(shard->next, shard,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed)) {}
+        }
+      }
+      ~claim()
+      {
+        if (shard)
+          shard->claimed.store(false, std::memory_order_release);
+      }
+    };
+    static thread_local claim c;
+    return c.shard;
+  }
+
+  clock_type::time_point start = clock_type::now();
+
+ public:
+  // enabled() true while sampling; enable(on) starts or stops sampling
+  static bool enabled() noexcept { return on.load(std::memory_order_relaxed); }
+  static void enable(bool b = true) noexcept
+  {
+    on.store(b, std::memory_order_relaxed);
+  }
+
+  latency() noexcept = default;
+  latency(latency const&) = delete;
+  latency& operator=(latency const&) = delete;
+  ~latency()
+  {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock_type::now() - start).count();
+    if (auto s = local())
+      s->add(ns < 0 ? 0 : std::uint64_t(ns));
+  }
+
+  // merge() the sum of all threads' histograms, at about this time
+  static latency_histogram merge() noexcept
+  {
+    latency_histogram h;
+    for (auto s = shards.load(std::memory_order_acquire); s; s = s->next)
+      for (std::size_t i = 0; i != latency_histogram::buckets; ++i)
+        h.counts[i] += s->counts[i].load(std::memory_order_relaxed);
+    return h;
+  }
+
+  // reset() zeroes all threads' histograms; concurrent samples may be lost
+  static void reset() noexcept
+  {
+    for (auto s = shards.load(std::memory_order_acquire); s; s = s->next)
+      for (auto& c : s->counts)
+        c.store(0, std::memory_order_relaxed);
+  }
+};
+
+// latency_of<&f> the latency Tag of instrumented<&f>, with f's histogram
+template <auto f>
+using latency_of = latency<std::integral_constant<decltype(f), f>>;
+
+// instrumented<&f, Tag> a function of f's type (or free form for &C::f)
+// calling f within the scope of a Tag object when Tag::enabled(); the
+// default Tag, latency_of<&f>, times calls of f
+template <auto f, class Tag = latency_of<f>>
+inline constexpr auto instrumented = &impl::instrument<f, Tag>::call;
+
+namespace impl
+{
+// column<T,N> an array of N values of type T; a struct-of-arrays member
+template <typename T, std::size_t N> struct column { T data[N]; };
+
+template <typename F, class B, std::size_t N,
+          typename = function_arg_types<F>>
+class batching;
+
+template <typename F, class B, std::size_t N, typename... P>
+class batching<F, B, N, arg_types<P...>>
+{
+  static_assert(is_free_function_v<F> && !function_is_variadic_v<F>,
+                "batching: F must be a non-variadic free function type");
+  static_assert(std::is_void_v<function_return_type_t<F>>,
+                "batching: F must return void");
+  static_assert(N != 0, "batching: zero batch size");
+  static constexpr bool nx = function_is_noexcept_v<F>;
+  static_assert(!nx || std::is_nothrow_invocable_v<B&, std::size_t,
+                                                   std::decay_t<P>*...>,
+                "batching: noexcept F requires a noexcept batch handler");
+
+  std::tuple<column<std::decay_t<P>, N>...> columns;
+  std::size_t size = 0;
+  B batch;
+
+ public:
+  explicit batching(B b = B{}) : batch(std::move(b)) {}
+  batching(batching const&) = delete;
+  batching& operator=(batching const&) = delete;
+  ~batching() { flush(); }
+
+  // operator() has exactly F's parameters P... and noexcept
+  void operator()(P... p) noexcept(nx)
+  {
+    std::apply([&](auto&... c) { ((c.data[size] = std::forward<P>(p)), ...); },
+               columns);
+    if (++size == N)
+      flush();
+  }
+
+  // flush() calls the batch handler on any buffered items; the buffer is
+  // emptied first, so a handler that throws discards its batch
+  void flush() noexcept(nx)
+  {
+    if (std::size_t n = std::exchange(size, 0))
+      std::apply([&](auto&... c) { batch(n, c.data...); }, columns);
+  }
+
+  std::size_t buffered() const noexcept { return size; }
+};
+} // namespace impl
+
+// batching<F, BatchF, N> buffers calls of signature F into batches of N
+template <typename F, class BatchF, std::size_t N = 64>
+class batching : public impl::batching<F, BatchF, N>
+{
+  using impl::batching<F, BatchF, N>::batching;
+};
+
+namespace impl
+{
+// accepts<R,G> checks that stage G's single parameter takes an R value
+template <typename R, typename G, typename = function_arg_types<G>>
+inline constexpr bool accepts = false;
+
+template <typename R, typename G, typename Q>
+inline constexpr bool accepts<R, G, arg_types<Q>> =
+                       !function_is_variadic_v<G> && std::is_convertible_v<R,Q>;
+
+// takes_lvalue<G> true if stage G's single parameter is an lvalue reference
+template <typename G, typename = function_arg_types<G>>
+inline constexpr bool takes_lvalue = false;
+
+template <typename G, typename Q>
+inline constexpr bool takes_lvalue<G, arg_types<Q>> =
+                                              std::is_lvalue_reference_v<Q>;
+
+template <auto f, auto... g>
+struct pipeline
+{
+  using type = typename callee<f>::type;
+  using return_type = function_return_type_t<type>;
+  static constexpr bool nx = function_is_noexcept_v<type>;
+
+  template <typename... A>
+  static return_type run(A&&... a) noexcept(nx)
+  {
+    return callee<f>::invoke(std::forward<A>(a)...);
+  }
+};
+
+template <auto f, auto g, auto... h>
+struct pipeline<f, g, h...>
+{
+  using type = typename callee<f>::type;
+  using next = pipeline<g, h...>;
+  using return_type = typename next::return_type;
+  static constexpr bool nx = function_is_noexcept_v<type> && next::nx;
+
+  static_assert(accepts<function_return_type_t<type>,
+                        typename callee<g>::type>,
+                "compose: a stage can't take the previous stage's result");
+
+  // run(a...) binds f's result to a local, passed on as an lvalue to a
+  // stage taking an lvalue (a prvalue object can't call a & member before
+  // C++20) and as an xvalue, so moved, to any other stage
+  template <typename... A>
+  static return_type run(A&&... a) noexcept(nx)
+  {
+    using R = function_return_type_t<type>;
+    R&& r = callee<f>::invoke(std::forward<A>(a)...);
+    if constexpr (takes_lvalue<typename callee<g>::type>)
+      return next::run(r);
+    else
+      return next::run(static_cast<R&&>(r));
+  }
+};
+
+template <class Pipe, typename = function_arg_types<typename Pipe::type>>
+struct composed;
+
+template <class Pipe, typename... P>
+struct composed<Pipe, arg_types<P...>>
+{
+  static_assert(!function_is_variadic_v<typename Pipe::type>,
+                "compose: C varargs can't be forwarded");
+
+  static typename Pipe::return_type call(P... p) noexcept(Pipe::nx)
+  {
+    return Pipe::run(std::forward<P>(p)...);
+  }
+};
+} // namespace impl
+
+// compose<&f, &g, ...> a function pointer to the fused call ...g(f(p...))
+template <auto f, auto... g>
+inline constexpr auto compose =
+                        &impl::composed<impl::pipeline<f, g...>>::call;
+
+namespace impl
+{
+// align_order<T...> stable sort of T... indices by decreasing alignment
+//   order[k] the index of the type stored at position k
+//   slot[i]  the position at which the type of index i is stored
+template <typename... T>
+struct align_order
+{
+  static constexpr std::size_t size = sizeof...(T);
+  struct map
+  {
+    std::size_t order[size + 1];
+    std::size_t slot[size + 1];
+  };
+  static constexpr map make()
+  {
+    std::size_t const align[] = {alignof(T)..., 0};
+    map m{};
+    for (std::size_t i = 0; i != size; ++i) {
+      std::size_t k = i;
+      for (; k != 0 && align[m.order[k - 1]] < align[i]; --k)
+        m.order[k] = m.order[k - 1];
+      m.order[k] = i;
+    }
+    for (std::size_t k = 0; k != size; ++k)
+      m.slot[m.order[k]] = k;
+    return m;
+  }
+  static constexpr map value = make();
+};
+
+// packed_leaf<K,T> the value of type T stored at position K
+template <std::size_t K, typename T> struct packed_leaf { T value; };
+
+template <typename F, typename = function_arg_types<F>,
+          typename = std::make_index_sequence<
+                       function_arg_types<F, align_order>::size>>
+class packed_args;
+
+template <typename F, typename... P, std::size_t... K>
+class packed_args<F, arg_types<P...>, std::index_sequence<K...>>
+  : packed_leaf<K, std::tuple_element_t<
+                     align_order<std::decay_t<P>...>::value.order[K],
+                     std::tuple<std::decay_t<P>...>>>...
+{
+  static_assert(!function_is_variadic_v<F>,
+                "packed_args: C varargs can't be stored");
+
+  using order = align_order<std::decay_t<P>...>;
+
+  template <std::size_t I>
+  using leaf = packed_leaf<order::value.slot[I],
+                  std::tuple_element_t<I, std::tuple<std::decay_t<P>...>>>;
+
+  template <std::size_t... I, class G>
+  decltype(auto) apply(std::index_sequence<I...>, G&& g)
+  {
+    if constexpr (function_is_reference_rvalue_v<F>)
+      return std::forward<G>(g)(std::move(leaf<I>::value)...);
+    else
+      return std::forward<G>(g)(leaf<I>::value...);
+  }
+
+ public:
+  // packed_args(p...) stores the parameters P... in packed order
+  explicit packed_args(P... p)
+    : packed_leaf<K, std::tuple_element_t<order::value.order[K],
+                       std::tuple<std::decay_t<P>...>>>{
+        std::get<order::value.order[K]>(
+          std::forward_as_tuple(std::forward<P>(p)...))}...
+  {}
+
+  // packed_args(std::in_place) value-initializes the stored values
+  explicit packed_args(std::in_place_t)
+    : packed_leaf<K, std::tuple_element_t<order::value.order[K],
+                       std::tuple<std::decay_t<P>...>>>{}...
+  {}
+
+  // slot(i) the storage position of the parameter of index i
+  static constexpr std::size_t slot(std::size_t i) noexcept
+  {
+    return order::value.slot[i];
+  }
+
+  template <std::size_t I>
+  auto& get() noexcept { return leaf<I>::value; }
+  template <std::size_t I>
+  auto const& get() const noexcept { return leaf<I>::value; }
+
+  // apply(g) calls g with the stored values in declaration order
+  template <class G>
+  decltype(auto) apply(G&& g)
+  {
+    return apply(std::index_sequence_for<P...>{}, std::forward<G>(g));
+  }
+};
+} // namespace impl
+
+// packed_args<F> alignment-packed storage for F's decayed parameter values
+template <typename F>
+class packed_args : public impl::packed_args<F>
+{
+  using impl::packed_args<F>::packed_args;
+};
+
+namespace impl
+{
+// bound_ref<H,S> the bind_front operator() qualifier needed to pass a
+// stored S value to parameter type H; 0: const&, 1: &, 2: &&
+template <typename H, typename S>
+inline constexpr int bound_ref = std::is_rvalue_reference_v<H> ? 2
+  : std::is_lvalue_reference_v<H> &&
+    !std::is_const_v<std::remove_reference_t<H>> ? 1 : 0;
+
+template <typename H, typename T>
+inline constexpr int bound_ref<H, std::reference_wrapper<T>> = 0;
+
+// unwrap(b) unwraps a std::reference_wrapper to its reference, whatever
+// the value category of b, else forwards b
+template <typename T> inline constexpr bool is_reference_wrapper = false;
+template <typename T>
+inline constexpr bool is_reference_wrapper<std::reference_wrapper<T>> = true;
+
+template <typename T> decltype(auto) unwrap(T&& b)
+{
+  if constexpr (is_reference_wrapper<std::remove_cv_t<
+                                       std::remove_reference_t<T>>>)
+    return b.get();
+  else
+    return static_cast<T&&>(b);
+}
+
+// bound_leaf<I,T> the bound value of index I, of type T; an empty class
+// T is a base, so takes no space whatever the standard library's tuple
+template <std::size_t I, typename T,
+          bool = std::is_empty_v<T> && !std::is_final_v<T>>
+struct bound_leaf
+{
+  T value;
+
+  template <typename B>
+  bound_leaf(std::in_place_t, B&& b) : value(std::forward<B>(b)) {}
+  T& get() noexcept { return value; }
+  T const& get() const noexcept { return value; }
+};
+
+template <std::size_t I, typename T>
+struct bound_leaf<I, T, true> : T
+{
+  template <typename B>
+  bound_leaf(std::in_place_t, B&& b) : T(std::forward<B>(b)) {}
+  T& get() noexcept { return *this; }
+  T const& get() const noexcept { return *this; }
+};
+
+// LTL_EMPTY_BASES lays out every empty base at offset zero; MSVC does so
+// only for the first empty base unless asked
+#if defined(_MSC_VER)
+#   define LTL_EMPTY_BASES __declspec(empty_bases)
+#else
+#   define LTL_EMPTY_BASES
+#endif
+
+template <auto f, typename Stored, typename Tail, int Ref, typename Is>
+class bound_front;
+
+// BOUND_FRONT(REF,QUAL,FWD) a bound_front specialization with operator()
+// qualified QUAL passing stored values as lvalues or, for &&, rvalues
+#define BOUND_FRONT(REF, QUAL, FWD)                                        \
+template <auto f, typename... S, typename... Q, std::size_t... I>          \
+class LTL_EMPTY_BASES bound_front<f, arg_types<S...>, arg_types<Q...>,      \
+                                  REF, std::index_sequence<I...>>           \
+  : bound_leaf<I, S>...                                                     \
+{                                                                           \
+  using F = typename callee<f>::type;                                       \
+ public:                                                                    \
+  template <typename... B>                                                  \
+  bound_front(std::in_place_t, B&&... b)                                    \
+    : bound_leaf<I, S>(std::in_place, std::forward<B>(b))... {}             \
+                                                                            \
+  function_return_type_t<F> operator()(Q... q) QUAL                        \
+                                       noexcept(function_is_noexcept_v<F>)  \
+  {                                                                         \
+    return callee<f>::invoke(unwrap(FWD(this->bound_leaf<I, S>::get()))..., \
+                             std::forward<Q>(q)...);                        \
+  }                                                                         \
+};
+
+BOUND_FRONT(0, const, )
+BOUND_FRONT(1, &, )
+BOUND_FRONT(2, &&, std::move)
+#undef BOUND_FRONT
+#undef LTL_EMPTY_BASES
+
+template <auto f, typename... S>
+struct bind_front_of
+{
+  using F = typename callee<f>::type;
+  static_assert(!function_is_variadic_v<F>,
+                "bind_front: C varargs can't be forwarded");
+  using split = split_at<sizeof...(S), arg_types<>, function_arg_types<F>>;
+
+  template <typename... H>
+  static constexpr int ref(arg_types<H...>*)
+  {
+    int r = 0;
+    ((r = bound_ref<H,S> > r ? bound_ref<H,S> : r), ...);
+    return r;
+  }
+  using type = bound_front<f, arg_types<S...>, typename split::tail,
+                           ref(static_cast<typename split::head*>(nullptr)),
+                           std::index_sequence_for<S...>>;
+};
+} // namespace impl
+
+// bind_front<&f>(b...) binds the first sizeof...(b) arguments of f
+template <auto f, typename... B>
+auto bind_front(B&&... b)
+{
+  return typename impl::bind_front_of<f, std::decay_t<B>...>::type{
+                                         std::in_place, std::forward<B>(b)...};
+}
+
+namespace impl
+{
+// erased_object<D>(b) the D object in inline storage at b
+template <class D>
+D& erased_object(void* b) noexcept
+{
+  return *std::launder(static_cast<D*>(b));
+}
+
+// erased_ops<S> call, move and destroy operations on an object in inline
+// storage, for signature S; erased_ops_for<D, S> the table for type D.
+// These are interned on S so that one table, and its functions, serve all
+// qualifier variants of S (the qualifiers are checked on storing a D)
+template <typename S, typename = function_arg_types<S>>
+struct erased_ops;
+
+template <typename S, typename... P>
+struct erased_ops<S, arg_types<P...>>
+{
+  using R = function_return_type_t<S>;
+
+  R (*call)(void*, P...);
+  void (*move)(void* to, void* from) noexcept;
+  void (*destroy)(void*) noexcept;
+
+  template <class D>
+  static R call_d(void* b, P... p)
+  {
+    return erased_object<D>(b)(std::forward<P>(p)...);
+  }
+};
+
+// erased_move<D>(to, from) moves the D object at from to to, destroying
+// the moved-from D; erased_destroy<D>(b) destroys the D object at b
+template <class D>
+void erased_move(void* to, void* from) noexcept
+{
+  ::new (to) D(std::move(erased_object<D>(from)));
+  erased_object<D>(from).~D();
+}
+template <class D>
+void erased_destroy(void* b) noexcept { erased_object<D>(b).~D(); }
+
+template <class D, typename S>
+inline constexpr erased_ops<S> erased_ops_for{
+  &erased_ops<S>::template call_d<D>, &erased_move<D>, &erased_destroy<D>};
+
+// fits_inline<D,N> D fits N bytes of inline storage and moves nothrow
+template <class D, std::size_t N>
+struct fits_inline
+  : std::bool_constant<sizeof(D) <= N
+                    && alignof(D) <= alignof(std::max_align_t)
+                    && std::is_nothrow_move_constructible_v<D>> {};
+
+template <typename F, std::size_t N, typename = function_arg_types<F>>
+class inline_function;
+
+template <typename F, std::size_t N, typename... P>
+class inline_function<F, N, arg_types<P...>>
+{
+  static_assert(is_free_function_v<F> && !function_is_variadic_v<F>,
+                "inline_function: F must be a non-variadic free function type");
+
+  using R = function_return_type_t<F>;
+  static constexpr bool nx = function_is_noexcept_v<F>;
+
+  using ops = erased_ops<function_signature_t<F>>;
+
+  alignas(std::max_align_t) unsigned char buf[N];
+  ops const* vt = nullptr;
+
+ public:
+  inline_function() noexcept = default;
+
+  // inline_function(t) stores a decay copy of callable t; only callables
+  // that fit, move nothrow and match F (noexcept included) are accepted
+  template <class T, class D = std::decay_t<T>,
+            class = std::enable_if_t<std::conjunction_v<
+              std::negation<std::is_same<D, inline_function>>,
+              std::is_constructible<D, T>,
+              fits_inline<D, N>,
+              std::conditional_t<nx, std::is_nothrow_invocable_r<R, D&, P...>,
+                                     std::is_invocable_r<R, D&, P...>>>>>
+  inline_function(T&& t) noexcept(std::is_nothrow_constructible_v<D, T>)
+  {
+    ::new (static_cast<void*>(buf)) D(std::forward<T>(t));
+    vt = &erased_ops_for<D, function_signature_t<F>>;
+  }
+
+  inline_function(inline_function&& o) noexcept : vt{o.vt}
+  {
+    if (vt)
+      vt->move(buf, o.buf);
+    o.vt = nullptr;
+  }
+
+  inline_function& operator=(inline_function&& o) noexcept
+  {
+    if (this != &o) {
+      if (vt)
+        vt->destroy(buf);
+      vt = o.vt;
+      if (vt)
+        vt->move(buf, o.buf);
+      o.vt = nullptr;
+    }
+    return *this;
+  }
+
+  ~inline_function()
+  {
+    if (vt)
+      vt->destroy(buf);
+  }
+
+  explicit operator bool() const noexcept { return vt != nullptr; }
+
+  // target<D>() the stored callable if it is of type D, else nullptr
+  template <class D>
+  D* target() noexcept
+  {
+    if (vt != &erased_ops_for<D, function_signature_t<F>>)
+      return nullptr;
+    return &erased_object<D>(buf);
+  }
+
+  // operator() calls the stored callable; requires a stored callable
+  R operator()(P... p) noexcept(nx)
+  {
+    return vt->call(buf, std::forward<P>(p)...);
+  }
+};
+} // namespace impl
+
+// inline_function<F, Bytes> non-allocating owner of a callable of type F
+template <typename F, std::size_t Bytes = 3 * sizeof(void*)>
+class inline_function : public impl::inline_function<F, Bytes>
+{
+  using impl::inline_function<F, Bytes>::inline_function;
+};
+
+namespace impl
+{
+// poly_table<V> a model type's vtable V with its move and destroy
+template <class V>
+struct poly_table
+{
+  V methods;
+  void (*move)(void* to, void* from) noexcept;
+  void (*destroy)(void*) noexcept;
+};
+
+template <class Interface, std::size_t N, class Hot>
+class poly;
+
+template <class... M, std::size_t N, class... H>
+class poly<vtable<M...>, N, vtable<H...>>
+{
+  using table = poly_table<vtable<M...>>;
+
+  template <class D>
+  static constexpr table table_for{vtable_for<D, M...>,
+                                   &erased_move<D>, &erased_destroy<D>};
+
+  template <class Tag>
+  static constexpr bool is_hot = (std::is_same_v<Tag, typename H::tag> || ...);
+
+  template <class Tag>
+  using entry_t = decltype(std::declval<vtable<M...>>().template get<Tag>());
+
+  alignas(std::max_align_t) unsigned char buf[N];
+  table const* vt = nullptr;
+  vtable<H...> hot{};
+
+  template <class Tag>
+  auto entry() const noexcept
+  {
+    if constexpr (is_hot<Tag>)
+      return hot.template get<Tag>();
+    else
+      return vt->methods.template get<Tag>();
+  }
+
+ public:
+  poly() noexcept = default;
+
+  // poly(t) stores a decay copy of model t; only a model that fits and
+  // moves nothrow is accepted
+  template <class T, class D = std::decay_t<T>,
+            class = std::enable_if_t<std::conjunction_v<
+              std::negation<std::is_same<D, poly>>,
+              std::is_constructible<D, T>, fits_inline<D, N>>>>
+  poly(T&& t) noexcept(std::is_nothrow_constructible_v<D, T>)
+    : vt{&table_for<D>}, hot{vtable_select<H...>(table_for<D>.methods)}
+  {
+    ::new (static_cast<void*>(buf)) D(std::forward<T>(t));
+  }
+
+  poly(poly&& o) noexcept : vt{o.vt}, hot{o.hot}
+  {
+    if (vt)
+      vt->move(buf, o.buf);
+    o.vt = nullptr;
+  }
+
+  poly& operator=(poly&& o) noexcept
+  {
+    if (this != &o) {
+      if (vt)
+        vt->destroy(buf);
+      vt = o.vt;
+      hot = o.hot;
+      if (vt)
+        vt->move(buf, o.buf);
+      o.vt = nullptr;
+    }
+    return *this;
+  }
+
+  ~poly()
+  {
+    if (vt)
+      vt->destroy(buf);
+  }
+
+  explicit operator bool() const noexcept { return vt != nullptr; }
+
+  // call<Tag>(a...) calls method Tag on the model; a hot method from its
+  // inline entry, others through the vtable. Requires a stored model
+  template <class Tag, class... A>
+  decltype(auto) call(A&&... a)
+    noexcept(std::is_nothrow_invocable_v<entry_t<Tag>, void*, A...>)
+  {
+    return entry<Tag>()(static_cast<void*>(buf), std::forward<A>(a)...);
+  }
+  template <class Tag, class... A>
+  decltype(auto) call(A&&... a) const
+    noexcept(std::is_nothrow_invocable_v<entry_t<Tag>, void const*, A...>)
+  {
+    return entry<Tag>()(static_cast<void const*>(buf),
+                        std::forward<A>(a)...);
+  }
+};
+} // namespace impl
+
+// poly<Interface, Bytes, Hot> owning value of any model of Interface,
+// stored inline, with the Hot vtable's methods held in the object
+template <class Interface, std::size_t Bytes = 3 * sizeof(void*),
+          class Hot = vtable<>>
+class poly : public impl::poly<Interface, Bytes, Hot>
+{
+  using impl::poly<Interface, Bytes, Hot>::poly;
+};
+
+namespace impl
+{
+// callback_function<CB> the function type of callback parameter type CB
+template <typename CB, typename = void>
+struct callback_function
+{
+  using type = typename member_function<decltype(&CB::operator())>::type;
+};
+template <typename CB>
+struct callback_function<CB, std::enable_if_t<std::is_pointer_v<CB>>>
+{
+  using type = std::remove_pointer_t<CB>;
+};
+template <typename CB>
+struct callback_function<CB, std::enable_if_t<std::is_reference_v<CB>>>
+  : callback_function<std::remove_cv_t<std::remove_reference_t<CB>>> {};
+
+template <typename... R>
+struct callback_results { using type = std::tuple<std::decay_t<R>...>; };
+template <typename R>
+struct callback_results<R> { using type = std::decay_t<R>; };
+template <>
+struct callback_results<> { using type = void; };
+
+// callback_op<&op> splits op's free form parameters into args and callback
+template <auto op, typename F = typename callee<op>::type,
+          typename = function_arg_types<F>>
+struct callback_op
+{
+  static_assert(!sizeof(F*), "callback_op: op takes no callback parameter");
+};
+
+template <auto op, typename F, typename P0, typename... P>
+struct callback_op<op, F, arg_types<P0, P...>>
+{
+  static_assert(!function_is_variadic_v<F>,
+                "callback_op: C varargs can't be forwarded");
+  using args = typename split_at<sizeof...(P), arg_types<>,
+                                 arg_types<P0, P...>>::head;
+  using callback = std::tuple_element_t<sizeof...(P), std::tuple<P0, P...>>;
+  using callback_function = typename impl::callback_function<callback>::type;
+  using result_type = typename function_arg_types<callback_function,
+                                                  callback_results>::type;
+};
+} // namespace impl
+
+// callback_result_t<&op> the decayed result type of op's trailing callback
+template <auto op>
+using callback_result_t = typename impl::callback_op<op>::result_type;
+
+#if defined(__cpp_impl_coroutine)
+namespace impl
+{
+template <auto op,
+          typename A = typename callback_op<op>::args,
+          typename R = function_arg_types<
+                         typename callback_op<op>::callback_function>>
+class awaitable;
+
+template <auto op, typename... A, typename... R>
+class awaitable<op, arg_types<A...>, arg_types<R...>>
+{
+  using callback = typename callback_op<op>::callback;
+  using result_type = callback_result_t<op>;
+  using result_store = std::conditional_t<std::is_void_v<result_type>,
+                                          bool, result_type>;
+
+  static_assert(!std::is_pointer_v<std::decay_t<callback>>,
+                "awaitable_from: a function pointer callback can't carry "
+                "the awaiting coroutine; op must take a callback class, "
+                "such as inline_function");
+
+  std::tuple<std::decay_t<A>...> args;
+  std::optional<result_store> result;
+  std::atomic<bool> done{false}; // set first by op's return or callback
+
+ public:
+  template <typename... B>
+  explicit awaitable(B&&... b) : args(std::forward<B>(b)...) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  bool await_suspend(std::coroutine_handle<> h)
+  {
+    std::apply([this, h](auto&... a) {
+      callee<op>::invoke(std::move(a)...,
+        std::decay_t<callback>([this, h](R... r) noexcept {
+          if constexpr (std::is_void_v<result_type>)
+            result.emplace(true);
+          else
+            result.emplace(std::forward<R>(r)...);
+          if (done.exchange(true))
+            h.resume();
+        }));
+    }, args);
+    return !done.exchange(true);
+  }
+
+  result_type await_resume()
+  {
+    if constexpr (!std::is_void_v<result_type>)
+      return std::move(*result);
+  }
+};
+} // namespace impl
+
+// awaitable_from<&op>(a...) an awaitable calling op(a..., cb) on co_await
+template <auto op, typename... B>
+auto awaitable_from(B&&... b)
+{
+  return impl::awaitable<op>(std::forward<B>(b)...);
+}
+
+// frame_arena<Bytes> a buffer of Bytes handing out coroutine frames by
+// bumping an offset, reset when the last frame is freed; frames that
+// don't fit come from operator new
+template <std::size_t Bytes>
+class frame_arena
+{
+  static constexpr std::size_t align = alignof(std::max_align_t);
+
+  alignas(align) unsigned char buf[Bytes];
+  std::size_t top = 0;
+  std::size_t live = 0;
+
+ public:
+  frame_arena() = default;
+  frame_arena(frame_arena const&) = delete;
+  frame_arena& operator=(frame_arena const&) = delete;
+
+  void* allocate(std::size_t n)
+  {
+    n = (n + align - 1) / align * align;
+    if (n > Bytes - top)
+      return ::operator new(n);
+    ++live;
+    top += n;
+    return buf + top - n;
+  }
+
+  void deallocate(void* p, std::size_t n) noexcept
+  {
+    auto b = static_cast<unsigned char*>(p);
+    if (b < buf || b >= buf + Bytes)
+      ::operator delete(p, (n + align - 1) / align * align);
+    else if (--live == 0)
+      top = 0;
+  }
+
+  // used() bytes handed out since the arena was last empty
+  std::size_t used() const noexcept { return top; }
+};
+
+// arena_frames<Arena> a base for a coroutine promise_type whose frames
+// come from the Arena& passed as the coroutine's first argument, or its
+// second for a member coroutine, after the object
+template <class Arena>
+struct arena_frames
+{
+ private:
+  static constexpr std::size_t head = alignof(std::max_align_t);
+
+  static void* allocate(std::size_t n, Arena& arena)
+  {
+    void* p = arena.allocate(n + head);
+    *static_cast<Arena**>(p) = &arena;
+    return static_cast<unsigned char*>(p) + head;
+  }
+
+ public:
+  template <typename... A>
+  static void* operator new(std::size_t n, Arena& arena, A const&...)
+  {
+    return allocate(n, arena);
+  }
+  template <class C, typename... A>
+  static void* operator new(std::size_t n, C const&, Arena& arena,
+                            A const&...)
+  {
+    return allocate(n, arena);
+  }
+  static void operator delete(void* p, std::size_t n) noexcept
+  {
+    void* b = static_cast<unsigned char*>(p) - head;
+    (*static_cast<Arena**>(b))->deallocate(b, n + head);
+  }
+};
+#endif
+
+namespace impl
+{
+template <auto f, auto on_error, typename F = typename callee<f>::type,
+          typename = function_arg_types<F>>
+struct nothrow;
+
+template <auto f, auto on_error, typename F, typename... P>
+struct nothrow<f, on_error, F, arg_types<P...>>
+{
+  static_assert(!function_is_variadic_v<F>,
+                "nothrow: C varargs can't be forwarded");
+  static_assert(std::is_nothrow_invocable_v<decltype(on_error)>,
+                "nothrow: on_error() must be a noexcept call");
+
+  using R = function_return_type_t<F>;
+  using X = std::invoke_result_t<decltype(on_error)>;
+
+  static X result(P... p)
+  {
+    if constexpr (std::is_void_v<R>) {
+      callee<f>::invoke(std::forward<P>(p)...);
+      return X();
+    }
+    else
+      return X(callee<f>::invoke(std::forward<P>(p)...));
+  }
+
+  static constexpr bool pass_through = function_is_noexcept_v<F>
+    && (std::is_void_v<R> ? std::is_nothrow_default_constructible_v<X>
+                          : std::is_nothrow_constructible_v<X, R>);
+
+  static X call(P... p) noexcept
+  {
+    if constexpr (pass_through)
+      return result(std::forward<P>(p)...);
+    else
+      try {
+        return result(std::forward<P>(p)...);
+      }
+      catch (...) {
+        return on_error();
+      }
+  }
+};
+} // namespace impl
+
+// nothrow<&f, &on_error> a noexcept function of f's parameters returning
+// f's result as an X, or on_error() if f throws
+template <auto f, auto on_error>
+inline constexpr auto nothrow = &impl::nothrow<f, on_error>::call;
+
+namespace impl
+{
+template <typename To, auto f, typename = function_arg_types<To>>
+struct convert;
+
+template <typename To, auto f, typename... P>
+struct convert<To, f, arg_types<P...>>
+{
+  static_assert(is_free_function_v<To> && !function_is_variadic_v<To>,
+                "function_convert: To must be a free, non-variadic "
+                "function type for a thunk");
+  static_assert(!function_is_noexcept_v<To>
+              || function_is_noexcept_v<typename callee<f>::type>,
+                "function_convert: To is noexcept but f may throw");
+
+  static function_return_type_t<To> call(P... p)
+                                           noexcept(function_is_noexcept_v<To>)
+  {
+    return static_cast<function_return_type_t<To>>(
+             callee<f>::invoke(std::forward<P>(p)...));
+  }
+};
+
+template <typename To, auto f>
+constexpr auto converted()
+{
+  using FP = decltype(f);
+  if constexpr (std::is_member_function_pointer_v<FP>) {
+    using C = typename member_function<FP>::class_type;
+    using F = typename member_function<FP>::type;
+    if constexpr (function_is_call_compatible_v<F, To>)
+      return static_cast<To C::*>(f);
+    else
+      return &convert<To, f>::call;
+  }
+  else if constexpr (function_is_call_compatible_v<
+                       std::remove_pointer_t<FP>, To>)
+    return static_cast<To*>(f);
+  else
+    return &convert<To, f>::call;
+}
+} // namespace impl
+
+// function_convert<To, &f> f as a To pointer, via a thunk only if needed
+template <typename To, auto f>
+inline constexpr auto function_convert = impl::converted<To, f>();
+
+namespace impl
+{
+// optimal_form<&f> optimal params for f, free form for &C::f keeping
+// the object parameter as a reference
+template <auto f, typename FP = decltype(f)>
+struct optimal_form
+{
+  using type = function_optimal_params_t<typename callee<f>::type>;
+};
+template <auto f, typename F, class C>
+struct optimal_form<f, F C::*>
+{
+  using type = function_arg_types<function_optimal_params_t<F>,
+                                  callee<f>::template object_first>;
+};
+
+template <auto f, typename F = typename callee<f>::type,
+          typename = function_arg_types<typename optimal_form<f>::type>>
+struct optimized;
+
+template <auto f, typename F, typename... P>
+struct optimized<f, F, arg_types<P...>>
+{
+  static_assert(!function_is_variadic_v<F>,
+                "optimal_params: C varargs can't be forwarded");
+
+  static function_return_type_t<F> call(P... p)
+                                            noexcept(function_is_noexcept_v<F>)
+  {
+    return callee<f>::invoke(std::forward<P>(p)...);
+  }
+};
+} // namespace impl
+
+// optimal_params<&f> a function of f's type with function_optimal_params_t
+// parameter passing that forwards to f
+template <auto f>
+inline constexpr auto optimal_params = &impl::optimized<f>::call;
+
+// LTL_SIMD_CLONES x86 kernels cloned per ISA by target attributes,
+// selected at run time by __builtin_cpu_supports
+#if (defined(__GNUC__) || defined(__clang__)) \
+ && (defined(__x86_64__) || defined(__i386__))
+#   define LTL_SIMD_CLONES 1
+#   define LTL_SIMD_INLINE [[gnu::always_inline]] inline
+#   define LTL_TARGET(isa) [[gnu::target(isa)]]
+#else
+#   define LTL_SIMD_CLONES 0
+#   define LTL_SIMD_INLINE inline
+#endif
+
+namespace impl
+{
+// simd_level() 2 for AVX-512F, 1 for AVX2, else 0, checked once
+inline int simd_level() noexcept
+{
+#if LTL_SIMD_CLONES
+  static int const level = __builtin_cpu_supports("avx512f") ? 2
+                         : __builtin_cpu_supports("avx2") ? 1 : 0;
+  return level;
+#else
+  return 0;
+#endif
+}
+} // namespace impl
+
+// simd_isa() the instruction set simd_map runs on: "avx512f", "avx2" or
+// "baseline", the compiler's target, which alone is used off x86
+inline char const* simd_isa() noexcept
+{
+  static char const* const names[] = {"baseline", "avx2", "avx512f"};
+  return names[impl::simd_level()];
+}
+
+namespace impl
+{
+template <auto f, std::size_t W,
+          typename F = std::remove_pointer_t<decltype(f)>,
+          typename = function_arg_types<F>>
+struct simd_map;
+
+template <auto f, std::size_t W, typename F, typename... P>
+struct simd_map<f, W, F, arg_types<P...>>
+{
+  static_assert(is_free_function_v<F> && !function_is_variadic_v<F>,
+                "simd_map requires a non-variadic free function");
+  using R = function_return_type_t<F>;
+  static_assert(std::is_arithmetic_v<R> && (std::is_arithmetic_v<P> && ...),
+                "simd_map: return and parameter types must be arithmetic");
+  static constexpr bool nx = function_is_noexcept_v<F>;
+  static constexpr std::size_t widest = std::max({sizeof(R), sizeof(P)...});
+
+  // lanes<V>() W, or else as many lanes as V vector bytes hold
+  template <std::size_t V>
+  static constexpr std::size_t lanes()
+  {
+    return W != 0 ? W : V > widest ? V / widest : 1;
+  }
+
+  // blocks<L> the loop in blocks of L lanes, as fixed trip count inner
+  // loops for the vectorizer, with a scalar tail; inlined into each clone
+  // so that it, and f if inlinable, compile for the clone's ISA. A block
+  // is computed into a local array, which can't alias in..., then stored
+  template <std::size_t L>
+  LTL_SIMD_INLINE static void blocks(std::size_t n, R* out, P const*... in)
+                                                              noexcept(nx)
+  {
+    std::size_t i = 0;
+    for (; i + L <= n; i += L) {
+      R lane[L];
+      for (std::size_t k = 0; k != L; ++k)
+        lane[k] = f(in[i + k]...);
+      for (std::size_t k = 0; k != L; ++k)
+        out[i + k] = lane[k];
+    }
+    for (; i != n; ++i)
+      out[i] = f(in[i]...);
+  }
+
+#if LTL_SIMD_CLONES
+  LTL_TARGET("avx512f")
+  static void avx512(std::size_t n, R* out, P const*... in) noexcept(nx)
+  {
+    blocks<lanes<64>()>(n, out, in...);
+  }
+  LTL_TARGET("avx2")
+  static void avx2(std::size_t n, R* out, P const*... in) noexcept(nx)
+  {
+    blocks<lanes<32>()>(n, out, in...);
+  }
+#endif
+  static void baseline(std::size_t n, R* out, P const*... in) noexcept(nx)
+  {
+    blocks<lanes<16>()>(n, out, in...);
+  }
+
+  static void map(std::size_t n, R* out, P const*... in) noexcept(nx)
+  {
+#if LTL_SIMD_CLONES
+    switch (simd_level()) {
+      case 2: return avx512(n, out, in...);
+      case 1: return avx2(n, out, in...);
+    }
+#endif
+    baseline(n, out, in...);
+  }
+};
+} // namespace impl
+
+// simd_map<&f, W> out[i] = f(in[i]...) over arrays, in lanes of the best
+// ISA found at run time; W lanes per block if nonzero, else a vector's
+template <auto f, std::size_t W = 0>
+inline constexpr auto simd_map = &impl::simd_map<f, W>::map;
+
+#undef LTL_TARGET
+#undef LTL_SIMD_INLINE
+#undef LTL_SIMD_CLONES
+
+// LTL_ALWAYS_INLINE inline, forced even in unoptimized builds
+#if defined(__GNUC__)
+#   define LTL_ALWAYS_INLINE [[gnu::always_inline]] inline
+#elif defined(_MSC_VER)
+#   define LTL_ALWAYS_INLINE __forceinline
+#else
+#   define LTL_ALWAYS_INLINE inline
+#endif
+
+// invoke(f, a...) std::invoke(f, a...) in one inlined call frame; casts
+// forward, as std::forward is an out-of-line call in unoptimized builds
+template <typename F, typename... A,
+          typename = std::enable_if_t<!std::is_member_pointer_v<
+                                        std::decay_t<F>>>>
+LTL_ALWAYS_INLINE constexpr decltype(auto) invoke(F&& f, A&&... a)
+                              noexcept(std::is_nothrow_invocable_v<F, A...>)
+{
+  return static_cast<F&&>(f)(static_cast<A&&>(a)...);
+}
+
+namespace impl
+{
+// member_nothrow<M,C,O,A...>() invoke(m, o, a...) can't throw; from the
+// call expression itself for an && member called on *o, as std::invoke
+// calls it on an lvalue *o, else as std::is_nothrow_invocable
+template <typename M, class C, typename O, typename... A>
+constexpr bool member_nothrow()
+{
+  using D = std::remove_cv_t<std::remove_reference_t<O>>;
+  if constexpr (std::is_function_v<M> && !std::is_base_of_v<C, D>
+                                      && !is_reference_wrapper<D>) {
+    if constexpr (function_is_reference_rvalue_v<M>) {
+      using T = std::remove_reference_t<decltype(*std::declval<O>())>;
+      return noexcept((static_cast<T&&>(*std::declval<O>())
+                         .*std::declval<M C::*>())(std::declval<A>()...));
+    }
+  }
+  return std::is_nothrow_invocable_v<M C::*, O, A...>;
+}
+} // namespace impl
+
+// invoke(m, o, a...) calls member m of object o, or of *o for o a pointer
+// or std::reference_wrapper; *o as an rvalue if m is && qualified
+template <typename M, class C, typename O, typename... A>
+LTL_ALWAYS_INLINE constexpr decltype(auto) invoke(M C::* m, O&& o, A&&... a)
+                           noexcept(impl::member_nothrow<M, C, O, A...>())
+{
+  using D = std::remove_cv_t<std::remove_reference_t<O>>;
+  if constexpr (std::is_function_v<M>) {
+    if constexpr (std::is_base_of_v<C, D>)
+      return (static_cast<O&&>(o).*m)(static_cast<A&&>(a)...);
+    else if constexpr (impl::is_reference_wrapper<D>)
+      return (o.get().*m)(static_cast<A&&>(a)...);
+    else if constexpr (function_is_reference_rvalue_v<M>) {
+      using T = std::remove_reference_t<decltype(*o)>;
+      return (static_cast<T&&>(*o).*m)(static_cast<A&&>(a)...);
+    }
+    else
+      return ((*o).*m)(static_cast<A&&>(a)...);
+  }
+  else {
+    static_assert(sizeof...(A) == 0, "invoke: data member takes no args");
+    if constexpr (std::is_base_of_v<C, D>)
+      return (static_cast<O&&>(o).*m);
+    else if constexpr (impl::is_reference_wrapper<D>)
+      return (o.get().*m);
+    else
+      return ((*o).*m);
+  }
+}
+
+// invoke_r<R>(f, a...) invoke(f, a...) converted to R, or discarded
+template <typename R, typename F, typename... A>
+LTL_ALWAYS_INLINE constexpr R invoke_r(F&& f, A&&... a)
+                           noexcept(std::is_nothrow_invocable_r_v<R, F, A...>)
+{
+  if constexpr (std::is_void_v<R>)
+    ltl::invoke(static_cast<F&&>(f), static_cast<A&&>(a)...);
+  else
+    return ltl::invoke(static_cast<F&&>(f), static_cast<A&&>(a)...);
+}
+
+#undef LTL_ALWAYS_INLINE
+
+namespace impl
+{
+// is_promoted<T> true if default argument promotion changes type T: float,
+// and bool, character, short integer or unscoped enum types that promote
+// to int; a parameter before ... of such type makes va_start undefined
+template <typename T, bool = std::is_integral_v<T>
+                             || (std::is_enum_v<T>
+                                 && std::is_convertible_v<T, int>)>
+inline constexpr bool is_promoted = std::is_same_v<T, float>;
+
+template <typename T>
+inline constexpr bool is_promoted<T, true> =
+                          !std::is_same_v<T, decltype(+std::declval<T>())>;
+
+template <auto f, auto vf, typename F = typename callee<f>::type,
+          typename = function_arg_types<F>>
+struct variadic_forwarder
+{
+  static_assert(!sizeof(F*),
+                "variadic_forwarder: f needs a parameter before ...");
+};
+
+template <auto f, auto vf, typename F, typename P0, typename... P>
+struct variadic_forwarder<f, vf, F, arg_types<P0, P...>>
+{
+  static_assert(function_is_variadic_v<F>,
+                "variadic_forwarder: f must be C-variadic");
+  static_assert(function_is_call_compatible_v<typename callee<vf>::type,
+                                              function_valist_t<F>>,
+                "variadic_forwarder: vf must have function_valist_t type");
+
+  using R = function_return_type_t<F>;
+  using L = std::tuple_element_t<sizeof...(P), std::tuple<P0, P...>>;
+  static_assert(!std::is_reference_v<L>,
+                "variadic_forwarder: va_start needs a non-reference "
+                "parameter before ...");
+  static_assert(!is_promoted<L>,
+                "variadic_forwarder: va_start needs a parameter before ... "
+                "of a type unchanged by default argument promotion");
+
+  template <typename Head> struct forward;
+
+  template <typename... H>
+  struct forward<arg_types<H...>>
+  {
+    static R call(H... h, L l, ...) noexcept(function_is_noexcept_v<F>)
+    {
+      std::va_list args;
+      va_start(args, l);
+      if constexpr (std::is_void_v<R>) {
+        callee<vf>::invoke(std::forward<H>(h)..., std::forward<L>(l), args);
+        va_end(args);
+      }
+      else {
+        R r = callee<vf>::invoke(std::forward<H>(h)..., std::forward<L>(l),
+                                 args);
+        va_end(args);
+        return r;
+      }
+    }
+  };
+
+  using type = forward<typename split_at<sizeof...(P), arg_types<>,
+                                         arg_types<P0, P...>>::head>;
+};
+} // namespace impl
+
+// variadic_forwarder<&f, &vf> a function of f's C-variadic type calling
+// vf, f's va_list variant, with its variable arguments
+template <auto f, auto vf>
+inline constexpr auto variadic_forwarder =
+                        &impl::variadic_forwarder<f, vf>::type::call;
+
+namespace impl
+{
+// type_layout<T>() a code for T's size, alignment and kind of type
+template <typename T>
+constexpr std::uint64_t type_layout()
+{
+  if constexpr (std::is_void_v<T>)
+    return 0;
+  else {
+    std::uint64_t kind = std::is_same_v<T, bool> ? 1
+                       : std::is_integral_v<T> ? std::is_signed_v<T> ? 2 : 3
+                       : std::is_floating_point_v<T> ? 4
+                       : std::is_pointer_v<T> ? 5
+                       : std::is_enum_v<T> ? 6
+                       : std::is_class_v<T> ? 7 : 8;
+    return kind | alignof(T) << 8 | std::uint64_t{sizeof(T)} << 16;
+  }
+}
+
+// layout_hash<F>() FNV-1a hash of F's type layouts and qualifier flags
+template <typename F, typename = function_arg_types<F>>
+inline constexpr std::uint64_t layout_hash = 0;
+
+template <typename F, typename... P>
+inline constexpr std::uint64_t layout_hash<F, arg_types<P...>> = [] {
+  std::uint64_t const words[] = {
+    function_qualifiers_v<F>, function_is_variadic_v<F>, sizeof...(P),
+    type_layout<function_return_type_t<F>>(),
+    type_layout<std::decay_t<P>>()...};
+  std::uint64_t h = 14695981039346656037u;
+  for (std::uint64_t w : words)
+    for (int b = 0; b != 64; b += 8)
+      h = (h ^ (w >> b & 0xff)) * 1099511628211u;
+  return h;
+}();
+
+// call_log_header the first bytes of a call log
+struct call_log_header
+{
+  char magic[8];
+  std::uint64_t hash;
+  std::uint64_t record_size;
+};
+
+template <typename F, typename = function_arg_types<F>>
+struct call_record;
+
+template <typename F, typename... P>
+struct call_record<F, arg_types<P...>>
+{
+  static_assert((std::is_trivially_copyable_v<std::decay_t<P>> && ...)
+             && (std::is_default_constructible_v<std::decay_t<P>> && ...),
+                "call_record: parameter types must be trivially copyable "
+                "and default constructible");
+
+  std::int64_t time;
+  packed_args<F> args;
+
+  static std::int64_t now() noexcept
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  static constexpr call_log_header header{
+    {'l','t','l','c','a','l','l','\0'}, layout_hash<F>, sizeof(call_record)};
+};
+} // namespace impl
+
+// call_record<F> the time of a call of type F and its packed arguments
+template <typename F>
+using call_record = impl::call_record<F>;
+
+namespace impl
+{
+template <typename F, std::size_t N, typename = function_arg_types<F>>
+class call_recorder;
+
+template <typename F, std::size_t N, typename... P>
+class call_recorder<F, N, arg_types<P...>>
+{
+  using record = call_record<F>;
+
+  std::FILE* log;
+  std::size_t size = 0;
+  alignas(record) unsigned char buf[N * sizeof(record)];
+
+ public:
+  // write_header(log) writes the log header, once per log, to stream log
+  static void write_header(std::FILE* log) noexcept
+  {
+    std::fwrite(&record::header, sizeof record::header, 1, log);
+  }
+
+  // call_recorder(log) appends records to stream log, after its header
+  explicit call_recorder(std::FILE* log) noexcept : log{log} {}
+  call_recorder(call_recorder const&) = delete;
+  call_recorder& operator=(call_recorder const&) = delete;
+  ~call_recorder() { flush(); }
+
+  // operator()(p...) records a call with arguments p... timed now
+  void operator()(P... p) noexcept
+  {
+    static_assert(std::is_trivially_copyable_v<record>);
+    record r{record::now(), packed_args<F>(std::forward<P>(p)...)};
+    std::memcpy(buf + size * sizeof(record), &r, sizeof(record));
+    if (++size == N)
+      flush();
+  }
+
+  // flush() writes the buffered records to the log
+  void flush() noexcept
+  {
+    if (size != 0)
+      std::fwrite(buf, sizeof(record), size, log);
+    size = 0;
+  }
+};
+
+template <typename F, typename = function_arg_types<F>>
+class call_replayer;
+
+template <typename F, typename... P>
+class call_replayer<F, arg_types<P...>>
+{
+  using record = call_record<F>;
+
+  std::FILE* log;
+  bool valid = false;
+
+ public:
+  // call_replayer(log) reads and checks the log header from stream log
+  explicit call_replayer(std::FILE* log) noexcept : log{log}
+  {
+    call_log_header h;
+    valid = std::fread(&h, sizeof h, 1, log) == 1
+         && std::memcmp(&h, &record::header, sizeof h) == 0;
+  }
+
+  // false if the log's header is missing or of another signature
+  explicit operator bool() const noexcept { return valid; }
+
+  // replay(handler, timed) calls handler(p...) for each logged call,
+  // spaced as recorded if timed, and returns the number of calls; each
+  // value is passed as an lvalue, or as an xvalue for a P&& parameter
+  template <class H>
+  std::size_t replay(H&& handler, bool timed = false)
+  {
+    return replay(std::index_sequence_for<P...>{}, handler, timed);
+  }
+
+ private:
+  template <std::size_t... I, class H>
+  std::size_t replay(std::index_sequence<I...>, H& handler, bool timed)
+  {
+    std::size_t n = 0;
+    std::int64_t first = 0, start = record::now();
+    record r{0, packed_args<F>(std::in_place)};
+    while (valid && std::fread(&r, sizeof r, 1, log) == 1) {
+      if (n++ == 0)
+        first = r.time;
+      else if (timed)
+        while (record::now() - start < r.time - first)
+          std::this_thread::yield();
+      handler(static_cast<std::conditional_t<std::is_rvalue_reference_v<P>,
+                                             std::decay_t<P>&&,
+                                             std::decay_t<P>&>>(
+                r.args.template get<I>())...);
+    }
+    return n;
+  }
+};
+} // namespace impl
+
+// call_recorder<F, N> records calls of signature F to a log stream
+template <typename F, std::size_t N = 256>
+class call_recorder : public impl::call_recorder<F, N>
+{
+  using impl::call_recorder<F, N>::call_recorder;
+};
+
+// call_replayer<F> replays the calls of signature F from a log stream
+template <typename F>
+class call_replayer : public impl::call_replayer<F>
+{
+  using impl::call_replayer<F>::call_replayer;
+};
+
+namespace impl
+{
+// site_bytes<D...> inline storage size for any of D... or the default size
+template <class... D>
+inline constexpr std::size_t site_bytes =
+  std::max({3 * sizeof(void*), sizeof(D)...});
+
+template <typename F, class Ds, std::size_t N,
+          typename = function_arg_types<F>>
+class cached_call_site;
+
+template <typename F, class... D, std::size_t N, typename... P>
+class cached_call_site<F, arg_types<D...>, N, arg_types<P...>>
+{
+  using R = function_return_type_t<F>;
+  static constexpr bool nx = function_is_noexcept_v<F>;
+  static constexpr std::size_t K = sizeof...(D);
+
+  static_assert((std::is_invocable_r_v<R, D&, P...> && ...),
+                "cached_call_site: a known target doesn't match F");
+
+  inline_function<F, N> fn;
+  std::size_t counts[K + 1] = {};
+
+  // call<I>(p...) tries known target I onwards, else the erased call
+  template <std::size_t I>
+  R call(P&&... p) noexcept(nx)
+  {
+    if constexpr (I == K) {
+      ++counts[K];
+      return fn(std::forward<P>(p)...);
+    } else {
+      using T = std::tuple_element_t<I, std::tuple<D...>>;
+      if (T* t = fn.template target<T>()) {
+        ++counts[I];
+        return (*t)(std::forward<P>(p)...);
+      }
+      return call<I + 1>(std::forward<P>(p)...);
+    }
+  }
+
+ public:
+  cached_call_site() noexcept = default;
+
+  template <class T, class = std::enable_if_t<
+                       !std::is_same_v<std::decay_t<T>, cached_call_site>
+                    && std::is_constructible_v<inline_function<F, N>, T>>>
+  cached_call_site(T&& t) noexcept(noexcept(inline_function<F, N>(
+                                              std::forward<T>(t))))
+    : fn(std::forward<T>(t)) {}
+
+  explicit operator bool() const noexcept { return bool(fn); }
+
+  // operator() calls the stored callable; requires a stored callable
+  R operator()(P... p) noexcept(nx)
+  {
+    return call<0>(std::forward<P>(p)...);
+  }
+
+  // hits(i) the number of calls of known target type i, i < sizeof...(D)
+  std::size_t hits(std::size_t i) const noexcept { return counts[i]; }
+
+  // hits() the number of calls of any known target type
+  std::size_t hits() const noexcept
+  {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i != K; ++i)
+      n += counts[i];
+    return n;
+  }
+
+  // misses() the number of erased calls, of unknown target types
+  std::size_t misses() const noexcept { return counts[K]; }
+
+  void reset_counts() noexcept
+  {
+    for (auto& c : counts)
+      c = 0;
+  }
+};
+} // namespace impl
+
+// cached_call_site<F, D...> inline_function of F caching known types D...
+template <typename F, class... D>
+class cached_call_site
+  : public impl::cached_call_site<F, arg_types<D...>, impl::site_bytes<D...>>
+{
+  using impl::cached_call_site<F, arg_types<D...>,
+                               impl::site_bytes<D...>>::cached_call_site;
+};
+
+namespace impl
+{
+// slot_readers counts hot_slot calls in flight on two epoch counters;
+// synchronize() flips the epoch and waits out each counter in turn
+class slot_readers
+{
+  std::atomic<unsigned> epoch{0};
+  std::atomic<std::size_t> active[2] = {{0}, {0}};
+  std::mutex writers;
+
+  friend class slot_call;
+
+ public:
+  // synchronize() waits until no call that started before it is in flight
+  void synchronize()
+  {
+    std::lock_guard<std::mutex> lock{writers};
+    for (int flip = 0; flip != 2; ++flip)
+    {
+      auto& count = active[epoch.fetch_add(1) & 1];
+      while (count.load() != 0)
+        std::this_thread::yield();
+    }
+  }
+};
+
+struct no_readers {};
+
+// slot_call marks a call in flight for its lifetime
+class slot_call
+{
+  std::atomic<std::size_t>& count;
+
+ public:
+  explicit slot_call(slot_readers& r) noexcept
+    : count{r.active[r.epoch.load() & 1]} { count.fetch_add(1); }
+  slot_call(slot_call const&) = delete;
+  ~slot_call() { count.fetch_sub(1, std::memory_order_release); }
+};
+
+template <typename F, bool G, typename = function_arg_types<F>>
+class hot_slot;
+
+template <typename F, bool G, typename... P>
+class hot_slot<F, G, arg_types<P...>>
+  : public std::conditional_t<G, slot_readers, no_readers>
+{
+  static_assert(!function_is_variadic_v<F>,
+                "hot_slot: F must be a non-variadic function type");
+
+  using R = function_return_type_t<F>;
+  static constexpr bool nx = function_is_noexcept_v<F>;
+
+ public:
+  using pointer = function_set_noexcept_t<function_signature_t<F>, nx>*;
+
+ private:
+  std::atomic<pointer> fp;
+
+ public:
+  explicit hot_slot(pointer f) noexcept : fp{f} {}
+
+  // operator() calls the current function
+  R operator()(P... p) noexcept(nx)
+  {
+    if constexpr (G) {
+      slot_call call{*this};
+      return fp.load()(std::forward<P>(p)...);
+    }
+    else
+      return fp.load(std::memory_order_acquire)(std::forward<P>(p)...);
+  }
+
+  // load() the current function
+  pointer load() const noexcept { return fp.load(std::memory_order_acquire); }
+
+  // swap(f) installs function f and returns the previous function
+  pointer swap(pointer f) noexcept { return fp.exchange(f); }
+};
+} // namespace impl
+
+// hot_slot<F, Grace> an atomic function pointer slot, swappable live
+template <typename F, bool Grace = false>
+class hot_slot : public impl::hot_slot<F, Grace>
+{
+  using impl::hot_slot<F, Grace>::hot_slot;
+};
+
+namespace impl
+{
+// call_signature_t<T> the function type of callable type T; the pointee
+// of a function pointer, the member function type of a member function
+// pointer or the type of class T's single operator()
+template <class T>
+struct call_signature
+{
+  using type = typename member_function<decltype(&T::operator())>::type;
+};
+template <typename F> struct call_signature<F*> { using type = F; };
+template <typename F, class C> struct call_signature<F C::*>
+{
+  using type = F;
+};
+template <class T>
+using call_signature_t = typename call_signature<T>::type;
+
+// tuple_invocable<F, std::tuple<T...>> F can be called with the elements
+// of an rvalue tuple<T...>, as std::apply calls it; and nothrow
+template <class F, class Tuple> struct tuple_invocable;
+template <class F, class... T> struct tuple_invocable<F, std::tuple<T...>>
+{
+  static constexpr bool value = std::is_invocable_v<F, T&&...>;
+  static constexpr bool nothrow = std::is_nothrow_invocable_v<F, T&&...>;
+};
+} // namespace impl
+
+// executor a work-stealing thread pool of inline noexcept task slots
+class executor
+{
+ public:
+  static constexpr std::size_t task_bytes = 8 * sizeof(void*);
+  using task = inline_function<void() noexcept, task_bytes>;
+
+ private:
+  struct alignas(64) worker
+  {
+    std::mutex m;
+    std::deque<task> tasks;
+  };
+
+  std::vector<worker> workers;
+  std::vector<std::thread> threads;
+  std::atomic<std::size_t> queued{0};   // tasks in deques
+  std::atomic<std::size_t> pending{0};  // tasks submitted, not yet done
+  std::atomic<std::size_t> next{0};     // round robin for outside submits
+  std::atomic<unsigned> sleepers{0};
+  std::atomic<bool> stopping{false};
+  std::mutex sleep;
+  std::condition_variable wake;
+
+  static inline thread_local executor* owner = nullptr;
+  static inline thread_local std::size_t self = 0;
+
+  void push(task&& t)
+  {
+    std::size_t n = workers.size();
+    std::size_t i = owner == this ? self : next.fetch_add(1) % n;
+    {
+      std::lock_guard<std::mutex> lock{workers[i].m};
+      workers[i].tasks.push_back(std::move(t));
+      pending.fetch_add(1); // counted once queued, before any take
+    }
+    queued.fetch_add(1);
+    if (sleepers.load() != 0) {
+      std::lock_guard<std::mutex> lock{sleep};
+      wake.notify_one();
+    }
+  }
+
+  // take(i, t) pops the back of deque i if owned, else steals a front
+  bool take(std::size_t i, bool own, task& t) noexcept
+  {
+    std::size_t n = workers.size();
+    for (std::size_t k = 0; k != n; ++k)
+    {
+      worker& w = workers[(i + k) % n];
+      std::lock_guard<std::mutex> lock{w.m};
+      if (w.tasks.empty())
+        continue;
+      if (own && k == 0) {
+        t = std::move(w.tasks.back());
+        w.tasks.pop_back();
+      } else {
+        t = std::move(w.tasks.front());
+        w.tasks.pop_front();
+      }
+      queued.fetch_sub(1);
+      return true;
+    }
+    return false;
+  }
+
+  // run(t) runs task t, then releases its state, before it counts as done
+  void run(task& t) noexcept
+  {
+    t();
+    t = task{};
+    pending.fetch_sub(1, std::memory_order_release);
+  }
+
+  void work(std::size_t i) noexcept
+  {
+    owner = this;
+    self = i;
+    task t;
+    for (;;)
+    {
+      if (take(i, true, t)) {
+        run(t);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock{sleep};
+      sleepers.fetch_add(1);
+      wake.wait(lock, [&] { return queued.load() != 0 || stopping.load(); });
+      sleepers.fetch_sub(1);
+      if (stopping.load() && queued.load() == 0)
+        return;
+    }
+  }
+
+  void stop() noexcept
+  {
+    {
+      std::lock_guard<std::mutex> lock{sleep};
+      stopping = true;
+      wake.notify_all();
+    }
+    for (auto& t : threads)
+      t.join();
+  }
+
+ public:
+  explicit executor(unsigned n = std::thread::hardware_concurrency())
+    : workers(std::max(n, 1u))
+  {
+    try {
+      for (std::size_t i = 0; i != workers.size(); ++i)
+        threads.emplace_back([this, i] { work(i); });
+    }
+    catch (...) {
+      stop();
+      throw;
+    }
+  }
+  executor(executor const&) = delete;
+  executor& operator=(executor const&) = delete;
+  ~executor()
+  {
+    wait();
+    stop();
+  }
+
+  std::size_t size() const noexcept { return workers.size(); }
+
+  // result<R> the inline result slot of a noexcept task returning R; it
+  // is neither copied nor moved, the task writes R into it in place, and
+  // its destructor waits for the task
+  template <typename R>
+  class result
+  {
+    friend class executor;
+    using V = std::conditional_t<std::is_reference_v<R>,
+                                 std::remove_reference_t<R>*, R>;
+
+    executor& ex;
+    std::atomic<bool> ready{false};
+    union { V value; };
+
+    template <class Call>
+    result(executor& x, Call&& call) : ex{x}
+    {
+      auto t = [this, call = std::move(call)]() mutable noexcept {
+        if constexpr (std::is_reference_v<R>) {
+          R&& r = call();
+          ::new (&value) V{&r};
+        }
+        else
+          ::new (&value) V(call());
+        ready.store(true, std::memory_order_release);
+      };
+      static_assert(std::is_constructible_v<task, decltype(t)>,
+                    "executor: f and its arguments don't fit a task slot");
+      ex.push(task{std::move(t)});
+    }
+
+   public:
+    result(result const&) = delete;
+    result& operator=(result const&) = delete;
+    ~result()
+    {
+      wait();
+      value.~V();
+    }
+
+    bool is_ready() const noexcept
+    {
+      return ready.load(std::memory_order_acquire);
+    }
+
+    // wait() runs queued tasks until this result is ready
+    void wait()
+    {
+      if (!is_ready())
+        ex.wait_until([this] { return is_ready(); });
+    }
+
+    // get() waits, then returns the result, left in place in the slot
+    std::conditional_t<std::is_reference_v<R>, R, R&> get()
+    {
+      wait();
+      if constexpr (std::is_reference_v<R>)
+        return static_cast<R>(*value);
+      else
+        return value;
+    }
+  };
+
+  // submit(f, a...) runs f(a...) as a task; void for a noexcept void f,
+  // a result<R> for a noexcept f returning R, else a std::future of R
+  template <class F, class... A>
+  auto submit(F&& f, A&&... a)
+  {
+    using S = impl::call_signature_t<std::decay_t<F>>;
+    using R = function_return_type_t<S>;
+    using with = impl::tuple_invocable<std::decay_t<F>, decltype(
+                   std::make_tuple(std::forward<A>(a)...))>;
+    static_assert(with::value,
+                  "executor: f can't be called with arguments a...");
+    constexpr bool nx = function_is_noexcept_v<S> && with::nothrow;
+
+    auto call = [f = std::forward<F>(f),
+                 args = std::make_tuple(std::forward<A>(a)...)]() mutable
+                 noexcept(nx) -> R {
+      return std::apply([&](auto&&... p) -> R {
+        return ltl::invoke(std::move(f), std::forward<decltype(p)>(p)...);
+      }, std::move(args));
+    };
+
+    if constexpr (nx && std::is_void_v<R>) {
+      static_assert(std::is_constructible_v<task, decltype(call)>,
+                    "executor: f and its arguments don't fit a task slot");
+      push(task{std::move(call)});
+    }
+    else if constexpr (nx)
+      return result<R>(*this, std::move(call));
+    else {
+      std::promise<R> promise;
+      std::future<R> result = promise.get_future();
+      auto t = [call = std::move(call),
+                promise = std::move(promise)]() mutable noexcept {
+        auto set = [&] {
+          if constexpr (std::is_void_v<R>) {
+            call();
+            promise.set_value();
+          }
+          else
+            promise.set_value(call());
+        };
+        try { set(); }
+        catch (...) { promise.set_exception(std::current_exception()); }
+      };
+      static_assert(std::is_constructible_v<task, decltype(t)>,
+                    "executor: f and its arguments don't fit a task slot");
+      push(task{std::move(t)});
+      return result;
+    }
+  }
+
+  // wait_until(done) runs queued tasks until done() returns true
+  template <class Done>
+  void wait_until(Done done)
+  {
+    std::size_t i = owner == this ? self : 0;
+    task t;
+    while (!done())
+      if (take(i, owner == this, t))
+        run(t);
+      else
+        std::this_thread::yield();
+  }
+
+  // wait() runs queued tasks until all submitted tasks are done; not
+  // to be called from a task
+  void wait()
+  {
+    wait_until([this] {
+      return pending.load(std::memory_order_acquire) == 0;
+    });
+  }
+};
+
+namespace impl
+{
+// parallel_pool() the executor shared by all parallel_apply calls,
+// started on first use with a worker per hardware thread but one, as
+// the caller works too; null if it can't be started
+inline executor* parallel_pool() noexcept
+{
+  struct holder
+  {
+    std::optional<executor> pool;
+    holder() noexcept
+    {
+      unsigned n = std::thread::hardware_concurrency();
+      try { pool.emplace(n > 1 ? n - 1 : 1); }
+      catch (...) {}
+    }
+  };
+  static holder h;
+  return h.pool ? &*h.pool : nullptr;
+}
+
+template <auto f, typename F = std::remove_pointer_t<decltype(f)>,
+          typename = function_arg_types<F>>
+struct parallel
+{
+  static_assert(!sizeof(F*),
+                "parallel_apply requires a function of one parameter");
+};
+
+template <auto f, typename F, typename P>
+struct parallel<f, F, arg_types<P>>
+{
+  static_assert(is_free_function_v<F> && !function_is_variadic_v<F>,
+                "parallel_apply requires a non-variadic free function");
+  static_assert(function_is_noexcept_v<F>,
+                "parallel_apply: f must be noexcept");
+  using R = function_return_type_t<F>;
+
+  template <typename T>
+  static decltype(auto) call(T& x) noexcept
+  {
+    if constexpr (std::is_rvalue_reference_v<P>)
+      return f(std::move(x));
+    else
+      return f(x);
+  }
+
+  // per_line<T> elements of T per (assumed 64 byte) cache line, or 1 if
+  // elements don't tile lines exactly
+  template <typename T>
+  static constexpr std::size_t per_line =
+      sizeof(T) < 64 && 64 % sizeof(T) == 0 ? 64 / sizeof(T) : 1;
+
+  // run(pool, out, n, body) calls body(i) for i in [0, n) in chunks of 64
+  // lines of output out[0, n), by the caller and tasks of pool, if any;
+  // chunk boundaries are 64 byte aligned addresses, the first chunk short
+  // by the head elements before out's first line
+  template <typename T, typename Body>
+  static void run(executor* pool, T* out, std::size_t n, Body body) noexcept
+  {
+    constexpr std::size_t chunk = 64 * per_line<T>;
+    std::size_t const head = per_line<T> == 1 ? 0
+                 : (reinterpret_cast<std::uintptr_t>(out) & 63) / sizeof(T);
+    std::atomic<std::size_t> next{0};
+    auto work = [&]() noexcept {
+      for (std::size_t k; (k = next.fetch_add(1, std::memory_order_relaxed))
+                          * chunk < n + head;)
+        for (std::size_t i = k == 0 ? 0 : k * chunk - head,
+                         e = std::min(n, (k + 1) * chunk - head); i < e; ++i)
+          body(i);
+    };
+    std::size_t const chunks = (n + head + chunk - 1) / chunk;
+    std::size_t const helpers = pool == nullptr || chunks < 2 ? 0
+                              : std::min(pool->size(), chunks - 1);
+    std::atomic<std::size_t> done{0};
+    std::size_t started = 0;
+    try {
+      for (; started != helpers; ++started)
+        pool->submit([&]() noexcept {
+          work();
+          done.fetch_add(1, std::memory_order_release);
+        });
+    }
+    catch (...) {} // run with the helpers queued, if any
+    work();
+    if (started != 0)
+      pool->wait_until([&] {
+        return done.load(std::memory_order_acquire) == started;
+      });
+  }
+
+  template <class Range>
+  static void apply(executor* pool, Range& range) noexcept
+  {
+    auto data = std::data(range);
+    run(pool, data, std::size(range), [data](std::size_t i) noexcept {
+      call(data[i]);
+    });
+  }
+
+  template <class In, class Out>
+  static void apply(executor* pool, In& in, Out& out) noexcept
+  {
+    static_assert(!std::is_void_v<R>,
+                  "parallel_apply: f must return a value to output");
+    auto src = std::data(in);
+    auto dst = std::data(out);
+    run(pool, dst, std::min(std::size(in), std::size(out)),
+        [src, dst](std::size_t i) noexcept {
+      dst[i] = call(src[i]);
+    });
+  }
+};
+} // namespace impl
+
+// parallel_apply<&f>(range) calls noexcept f on each element in parallel
+template <auto f, class Range>
+void parallel_apply(Range&& range) noexcept
+{
+  impl::parallel<f>::apply(impl::parallel_pool(), range);
+}
+
+// parallel_apply<&f>(in, out) sets out[i] = f(in[i]) in parallel
+template <auto f, class In, class Out>
+void parallel_apply(In&& in, Out&& out) noexcept
+{
+  impl::parallel<f>::apply(impl::parallel_pool(), in, out);
+}
+
+// parallel_apply<&f>(ex, range) parallel_apply<&f>(range) on executor ex
+template <auto f, class Range>
+void parallel_apply(executor& ex, Range&& range) noexcept
+{
+  impl::parallel<f>::apply(&ex, range);
+}
+
+// parallel_apply<&f>(ex, in, out) parallel_apply<&f>(in, out) on ex
+template <auto f, class In, class Out>
+void parallel_apply(executor& ex, In&& in, Out&& out) noexcept
+{
+  impl::parallel<f>::apply(&ex, in, out);
+}
+
+} // namespace ltl
+
+#endif // LTL_FUNCTION_ADAPTORS_HPP
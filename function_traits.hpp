@@ -5,6 +5,11 @@
 //
 //   Repo: https://github.com/willwray/function_traits
 
+#ifndef LTL_FUNCTION_TRAITS_HPP
+#define LTL_FUNCTION_TRAITS_HPP
+
+#include <cstdarg>
+#include <cstddef>
 #include <type_traits>
 
 /*
@@ -96,6 +101,16 @@
    so it must be 'guarded' e.g. by logic traits (2) or constexpr-if (3)
    (note - ltl::is_function avoids redundant work of std::is_function).
 
+   A binary predicate tells when a (member) function pointer converts:
+
+     function_is_call_compatible_v<From,To> // From* converts to To*, as
+                             // From C::* to To C::*, with no thunk needed
+
+   The only such standard conversion between distinct function types
+   drops noexcept, so this is true for From = To or From = To noexcept.
+   Signatures and cvref qualifiers must match exactly; e.g. a const
+   member function can't be called via a pointer to non-const member.
+
  Modifying traits
  ================
    Conventional 'add' and 'remove' traits modify their named trait:
@@ -142,6 +157,33 @@
    A trait is provided to copy all cvref qualifiers, otherwise verbose:
 
      function_set_cvref_as_t<F,G> // copy cvref quals of G to F
+
+   All cvref and noexcept qualifiers can be read as one flag word value,
+   an or-combination of function_qual enumerators, and set from one:
+
+     function_qualifiers_v<F>       // F's qualifier flags, 24 values
+     function_set_qualifiers_t<F,Q> // F with the qualifiers flagged in Q
+
+   so that F is split into function_signature_t<F> and a runtime value,
+   e.g. as a key to share code between qualifier variants of a signature:
+
+     function_set_qualifiers_t<function_signature_t<F>,
+                               function_qualifiers_v<F>>   // is F
+
+   A parameter passing trait rewrites the signature's parameter types:
+
+     function_optimal_params_t<F,N> // F with each parameter T or T const&
+                                    // passed by value if T is trivially
+                                    // copyable of size <= N bytes, else
+                                    // by const& (N = 2 registers default)
+
+   Other reference parameters, and move-only by-value parameters, keep
+   their type. Return type, varargs, cvref and noexcept are preserved.
+
+   A C-variadic function type maps to the type of its 'v' variant:
+
+     function_valist_t<F>    // R(P..., va_list) cvref noexcept(X) for
+                             // F = R(P..., ...) cvref noexcept(X)
 */
 
 #if !defined(__cpp_noexcept_function_type)
@@ -151,7 +193,8 @@
 
 // GCC and Clang deduce noexcept via partial specialization
 // MSVC doesn't deduce yet (early 2019 V 15.9.4 Preview 1.0)
-#if defined(__GNUC__)
+// Define LTL_NO_NOEXCEPT_DEDUCTION to take the MSVC path on GCC and Clang
+#if defined(__GNUC__) && !defined(LTL_NO_NOEXCEPT_DEDUCTION)
 #   define NOEXCEPT_DEDUCED
 #endif
 
@@ -193,6 +236,16 @@ template <typename...> struct arg_types;
 //   lval_ref_v    lvalue reference qualifier: &
 enum ref_qual { null_ref_v, rval_ref_v, lval_ref_v = 3 };
 
+// function_qual: flags for the cvref and noexcept qualifiers of a function
+// type; an lvalue & qualifier sets both reference flags (as in ref_qual)
+enum function_qual : unsigned {
+  const_qual_v = 1,
+  volatile_qual_v = 2,
+  rval_ref_qual_v = 4,
+  lval_ref_qual_v = 12,
+  noexcept_qual_v = 16
+};
+
 // ref_qual operator+( ref_qual, ref_qual)
 // 'adds' reference qualifiers with reference collapse
 constexpr ref_qual operator+( ref_qual a, ref_qual b)
@@ -323,42 +376,52 @@ class function_base<R(P...__VA_ARGS__)>                                \
   template <bool c, bool v, ref_qual r, bool nx>\
   using set_cvref_noexcept_t = typename decltype(\
         set_cvref_noexcept<c,v,r,nx>())::type;\
+ protected:                                                            \
+  template <typename r> using return_as_t = r(P...__VA_ARGS__);        \
+  template <bool V> using variadic_as_t = std::conditional_t<V,        \
+                                            R(P..., ...), R(P...)>;    \
 } // Macro end ////////////////////////////////////////////////////////////////
 
 FUNCTION_BASE(,);
 FUNCTION_BASE(,,...); // leading comma forwarded via macro varargs
 #undef FUNCTION_BASE
 
+// function_cvref_traits<S,c,v,ref,nx>
+// The body of function_traits<F> for F of signature S and given cvref and
+// noexcept properties; so that each specialization is a thin derivation.
+template <typename S, bool c, bool v, ref_qual ref, bool nx>
+class function_cvref_traits
+  : public function_base<S>,
+    public function_cvref_nx<function_base<S>::template set_cvref_noexcept_t,
+                             c, v, ref, nx>
+{
+  using base = function_base<S>;
+  template <typename B>
+  using cvref_nx_t = typename function_base<B>::template
+                     set_cvref_noexcept_t<c, v, ref, nx>;
+ public:
+  using type = cvref_nx_t<S>;
+  using remove_cvref_t = typename base::template
+                         set_cvref_noexcept_t<false, false, null_ref_v, nx>;
+  template <typename r> using set_return_type_t =
+      cvref_nx_t<typename base::template return_as_t<r>>;
+  template <bool V> using set_variadic_t =
+      cvref_nx_t<typename base::template variadic_as_t<V>>;
+  template <typename B> using set_signature_t = cvref_nx_t<B>;
+};
+
 } // namespace impl
 
 // function_traits<F> specializations for 24 cvref varargs combinations
-//                          or for 48 cvref varargs noexcept combinations
+//                          or for 48 cvref varargs noexcept combinations;
+// either way, each is a thin derivation from one function_cvref_traits
+// body, with noexcept deduced as X, or split off by matching NX directly
 #define CV_REF(CV,REF,NX,...) \
 template <typename R, typename... P NOEXCEPT_ND(,,bool X)>                   \
 class function_traits<R(P...__VA_ARGS__) CV REF noexcept(NOEXCEPT_ND(NX,X))> \
-    : public impl::function_base<R(P...__VA_ARGS__)>,                        \
-      public impl::function_cvref_nx<                                        \
-          impl::function_base<R(P...__VA_ARGS__)>::                          \
-          template set_cvref_noexcept_t,                                     \
+    : public impl::function_cvref_traits<R(P...__VA_ARGS__),                 \
           std::is_const_v<int CV>, std::is_volatile_v<int CV>,               \
-          reference_v<int REF>, NOEXCEPT_ND(NX,X)>                           \
-{                                                                            \
-  template <typename> struct set_signature;                                  \
-  template <typename r, typename... p> struct set_signature<r(p...)> {       \
-    using type = r(p...) CV REF noexcept(NOEXCEPT_ND(NX,X)); };              \
-  template <typename r, typename... p> struct set_signature<r(p..., ...)> {  \
-    using type = r(p..., ...) CV REF noexcept(NOEXCEPT_ND(NX,X)); };         \
-public:                                                                      \
-  using type = R(P...__VA_ARGS__) CV REF noexcept(NOEXCEPT_ND(NX,X));        \
-  using remove_cvref_t = R(P...__VA_ARGS__) noexcept(NOEXCEPT_ND(NX,X));     \
-  template <typename r> using set_return_type_t =                            \
-      r(P...__VA_ARGS__) CV REF noexcept(NOEXCEPT_ND(NX,X));                 \
-  template <bool V> using set_variadic_t = std::conditional_t<V,             \
-      R(P..., ...) CV REF noexcept(NOEXCEPT_ND(NX,X)),                       \
-      R(P...) CV REF noexcept(NOEXCEPT_ND(NX, X))>;                          \
-  template <typename B>                                                      \
-  using set_signature_t = typename set_signature<B>::type;                   \
-};
+          reference_v<int REF>, NOEXCEPT_ND(NX,X)> {};
 
 // CV_REF_QUALIFIERS(...)
 // X-macro list to expand the 12 cv-ref combos, and
@@ -717,4 +780,91 @@ template <typename F,
           template <typename...> typename T = arg_types>
 using function_arg_types = typename function_traits<F>::template arg_types<T>;
 
+// is_call_compatible: true if From is To or To with noexcept added
+template <typename From, typename To>
+inline constexpr bool function_is_call_compatible_v =
+                        std::is_same_v<From, To>
+                     || std::is_same_v<From, function_add_noexcept_t<To>>;
+template <typename From, typename To> struct function_is_call_compatible
+        : std::bool_constant<function_is_call_compatible_v<From, To>> {};
+
+namespace impl
+{
+// param_mode<P,N>: 0 keep P, 1 pass by value, 2 pass by const&
+template <typename P, std::size_t N>
+constexpr int param_mode()
+{
+  using T = std::remove_cv_t<std::remove_reference_t<P>>;
+  if constexpr (!std::is_same_v<P, T> && !std::is_same_v<P, T const&>)
+    return 0;
+  else if constexpr (std::is_trivially_copyable_v<T>)
+    return sizeof(T) <= N ? 1 : 2;
+  else
+    return std::is_same_v<P, T> && !std::is_copy_constructible_v<T> ? 0 : 2;
+}
+
+template <typename P, std::size_t N,
+          typename T = std::remove_cv_t<std::remove_reference_t<P>>>
+using optimal_param_t = std::conditional_t<param_mode<P, N>() == 0, P,
+                        std::conditional_t<param_mode<P, N>() == 1, T,
+                                           T const&>>;
+
+template <typename F, std::size_t N>
+struct optimal_params
+{
+  template <typename... P>
+  using signature = function_return_type_t<F>(optimal_param_t<P, N>...);
+
+  using type = function_set_signature_t<F,
+                 function_set_variadic_t<function_arg_types<F, signature>,
+                                         function_is_variadic_v<F>>>;
+};
+} // namespace impl
+
+// optimal_params: F with parameters passed by value or const& by size
+template <typename F, std::size_t N = 2 * sizeof(void*)>
+using function_optimal_params_t = typename impl::optimal_params<F, N>::type;
+template <typename F, std::size_t N = 2 * sizeof(void*)>
+using function_optimal_params =
+  function_traits<function_optimal_params_t<F, N>>;
+
+// qualifiers: cvref and noexcept as a function_qual flag word value
+template <typename F>
+inline constexpr unsigned function_qualifiers_v =
+    (function_is_const_v<F> ? const_qual_v : 0u)
+  | (function_is_volatile_v<F> ? volatile_qual_v : 0u)
+  | static_cast<unsigned>(function_reference_v<F>) << 2
+  | (function_is_noexcept_v<F> ? noexcept_qual_v : 0u);
+
+// set_qualifiers: set cvref and noexcept from a function_qual flag word
+template <typename F, unsigned Q>
+using function_set_qualifiers_t = function_set_noexcept_t<
+    function_set_cvref_t<F, bool(Q & const_qual_v), bool(Q & volatile_qual_v),
+                         static_cast<ref_qual>(Q >> 2 & 3)>,
+    bool(Q & noexcept_qual_v)>;
+template <typename F, unsigned Q>
+using function_set_qualifiers = function_traits<function_set_qualifiers_t<F,Q>>;
+
+namespace impl
+{
+template <typename F>
+struct valist
+{
+  static_assert(function_is_variadic_v<F>,
+                "function_valist_t requires a C-variadic function type");
+  template <typename... P>
+  using signature = function_return_type_t<F>(P..., std::va_list);
+
+  using type = function_set_signature_t<F, function_arg_types<F, signature>>;
+};
+} // namespace impl
+
+// valist: R(P..., ...) to R(P..., va_list), keeping cvref and noexcept
+template <typename F>
+using function_valist_t = typename impl::valist<F>::type;
+template <typename F>
+using function_valist = function_traits<function_valist_t<F>>;
+
 } // namespace ltl
+
+#endif // LTL_FUNCTION_TRAITS_HPP
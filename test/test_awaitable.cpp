@@ -0,0 +1,93 @@
+// C++20 test of awaitable_from; built as -std=c++20 only where the
+// compiler supports coroutines, and a no-op without them
+#include "function_adaptors.hpp"
+
+#define SAME(...) static_assert(std::is_same_v<__VA_ARGS__> );
+
+// Fails counts runtime check failures; main returns nonzero on any failure
+static int fails = 0;
+#define CHECK(...) (void)((__VA_ARGS__) || ++fails)
+
+// Callback-style async operations; these complete immediately or later
+using Done = ltl::inline_function<void() noexcept>;
+using Sum = ltl::inline_function<void(int) noexcept>;
+using Split = ltl::inline_function<void(int, long const&) noexcept>;
+
+Sum pending;
+
+void async_sum(int a, int b, Sum cb) { cb(a + b); }
+void async_later(int a, Sum cb) { pending = std::move(cb); (void)a; }
+void async_split(long x, Split cb) { cb(int(x % 10), x / 10); }
+void async_done(Done cb) { cb(); }
+void c_style(int, void (*)(int, char const*)) {}
+
+SAME( ltl::callback_result_t<&async_sum>, int );
+SAME( ltl::callback_result_t<&async_split>, std::tuple<int, long> );
+SAME( ltl::callback_result_t<&async_done>, void );
+SAME( ltl::callback_result_t<&c_style>, std::tuple<int, char const*> );
+
+#if defined(__cpp_impl_coroutine)
+
+// An eager coroutine task type with no result
+struct task
+{
+  struct promise_type
+  {
+    task get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { ++fails; }
+  };
+};
+
+// The same, its frames from a frame_arena passed first
+using Arena = ltl::frame_arena<1024>;
+struct arena_task
+{
+  struct promise_type : ltl::arena_frames<Arena>
+  {
+    arena_task get_return_object() noexcept { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { ++fails; }
+  };
+};
+
+int result = 0;
+
+arena_task run_in(Arena&, int a)
+{
+  result += co_await ltl::awaitable_from<&async_later>(a);
+}
+
+task run()
+{
+  int s = co_await ltl::awaitable_from<&async_sum>(2, 3);
+  auto [lo, hi] = co_await ltl::awaitable_from<&async_split>(123L);
+  co_await ltl::awaitable_from<&async_done>();
+  result = s + lo + int(hi);
+  result += co_await ltl::awaitable_from<&async_later>(0);
+}
+
+int main()
+{
+  run();
+  CHECK( result == 5 + 3 + 12 && pending );
+  pending(100);
+  CHECK( result == 5 + 3 + 12 + 100 );
+
+  Arena arena;
+  run_in(arena, 0);
+  CHECK( arena.used() != 0 && pending );
+  pending(1);
+  CHECK( arena.used() == 0 && result == 5 + 3 + 12 + 100 + 1 );
+  return fails;
+}
+
+#else
+
+int main() { return fails; }
+
+#endif
@@ -0,0 +1,1271 @@
+#include "function_adaptors.hpp"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define SAME(...) static_assert(std::is_same_v<__VA_ARGS__> );
+
+// Fails counts runtime check failures; main returns nonzero on any failure
+static int fails = 0;
+#define CHECK(...) (void)((__VA_ARGS__) || ++fails)
+
+namespace c_thunk
+{
+struct Acc
+{
+  int n = 0;
+  int add(int k) noexcept { return n += k; }
+  int get() const { return n; }
+  int take(int& out) && { out = n; n = 0; return out; }
+  void scale(int k, char, long) volatile noexcept { n = n * k; }
+};
+
+template <auto f> using type = std::remove_const_t<decltype(f)>;
+
+SAME( type<ltl::c_thunk<&Acc::add>>, int(*)(void*, int) noexcept );
+SAME( type<ltl::c_thunk<&Acc::add,1>>, int(*)(int, void*) noexcept );
+SAME( type<ltl::c_thunk<&Acc::get>>, int(*)(void*) );
+SAME( type<ltl::c_thunk<&Acc::take>>, int(*)(void*, int&) );
+SAME( type<ltl::c_thunk<&Acc::scale,2>>,
+                               void(*)(int, char, void*, long) noexcept );
+SAME( type<ltl::c_thunk<&Acc::scale,3>>,
+                               void(*)(int, char, long, void*) noexcept );
+
+// qsort_r style comparator with trailing user data
+struct Cmp
+{
+  bool desc;
+  int operator()(void const* a, void const* b) const noexcept
+  {
+    int const x = *static_cast<int const*>(a);
+    int const y = *static_cast<int const*>(b);
+    return desc ? y - x : x - y;
+  }
+};
+SAME( type<ltl::c_thunk_for<Cmp,2>>,
+      int(*)(void const*, void const*, void*) noexcept );
+
+void run()
+{
+  Acc acc;
+  CHECK( ltl::c_thunk<&Acc::add>(&acc, 2) == 2 );
+  CHECK( ltl::c_thunk<&Acc::add,1>(3, &acc) == 5 );
+  CHECK( ltl::c_thunk<&Acc::get>(&acc) == 5 );
+  ltl::c_thunk<&Acc::scale,1>(2, &acc, 'c', 0L);
+  int out = 0;
+  CHECK( ltl::c_thunk<&Acc::take>(&acc, out) == 10 && acc.n == 0 );
+
+  int sum = 0;
+  auto inc = [&sum](int k) noexcept { sum += k; };
+  void (*cb)(void*, int) noexcept = ltl::c_thunk_for<decltype(inc)>;
+  cb(&inc, 4);
+  cb(&inc, 5);
+  CHECK( sum == 9 );
+
+  Cmp cmp{true};
+  int a = 1, b = 2;
+  CHECK( ltl::c_thunk_for<Cmp,2>(&a, &b, &cmp) > 0 );
+}
+} // namespace c_thunk
+
+namespace vtable
+{
+// Method name tags dispatch to the model, customization point style
+struct area {
+  template <class T> long operator()(T const& t) const { return t.area(); }
+};
+struct scale {
+  template <class T> void operator()(T& t, int k) const noexcept {
+    t.scale(k);
+  }
+};
+struct name {
+  template <class T> char const* operator()(T&&) const noexcept {
+    return T::name;
+  }
+};
+
+using Area = ltl::method<area, long() const>;
+using Scale = ltl::method<scale, void(int) noexcept>;
+using Name = ltl::method<name, char const*() && noexcept>;
+
+using Shape = ltl::vtable<Area, Scale, Name>;
+
+struct Square {
+  long s;
+  long area() const { return s * s; }
+  void scale(int k) noexcept { s *= k; }
+  static constexpr char const* name = "square";
+};
+struct Rect {
+  long w, h;
+  long area() const { return w * h; }
+  void scale(int k) noexcept { w *= k; h *= k; }
+  static constexpr char const* name = "rect";
+};
+
+template <class T>
+constexpr Shape const& shape = ltl::vtable_for<T, Area, Scale, Name>;
+
+SAME( decltype(shape<Square>.get<area>()), long(*)(void const*) );
+SAME( decltype(shape<Square>.get<scale>()), void(*)(void*, int) noexcept );
+SAME( decltype(shape<Square>.get<name>()), char const*(*)(void*) noexcept );
+
+// Hot method held inline by value, as a one-entry vtable
+constexpr ltl::vtable<Area> square_area = ltl::vtable_select<Area>(
+                                                              shape<Square>);
+static_assert( square_area.get<area>() == shape<Square>.get<area>() );
+static_assert( sizeof(square_area) == sizeof(void*) );
+
+using Poly = ltl::poly<Shape, 2 * sizeof(long), ltl::vtable<Area>>;
+
+SAME( decltype(std::declval<Poly&>().call<area>()), long );
+static_assert( noexcept(std::declval<Poly&>().call<scale>(1)) );
+static_assert( ! noexcept(std::declval<Poly&>().call<area>()) );
+static_assert( std::is_nothrow_move_constructible_v<Poly> );
+static_assert( ! std::is_constructible_v<ltl::poly<Shape, sizeof(long)>,
+                                         Rect> );
+
+void run()
+{
+  Square sq{3};
+  Rect re{2, 5};
+  struct { void* self; Shape const* vt; } objs[] = {{&sq, &shape<Square>},
+                                                    {&re, &shape<Rect>}};
+  long total = 0;
+  for (auto& o : objs) {
+    o.vt->get<scale>()(o.self, 2);
+    total += o.vt->get<area>()(o.self);
+  }
+  CHECK( total == 36 + 40 );
+  CHECK( objs[1].vt->get<name>()(objs[1].self)[0] == 'r' );
+  CHECK( shape<Square>.get<area>() != shape<Rect>.get<area>() );
+
+  // Invokers are interned: scale's noexcept and & variants share one
+  using ScaleAny = ltl::method<scale, void(int) &>;
+  CHECK( ltl::vtable_for<Square, ScaleAny>.get<scale>()
+         == shape<Square>.get<scale>() );
+
+  // poly owns its model inline; area is hot, held in the object
+  std::vector<Poly> shapes;
+  shapes.emplace_back(Square{3});
+  shapes.emplace_back(Rect{2, 5});
+  total = 0;
+  for (auto& p : shapes) {
+    p.call<scale>(2);
+    total += std::as_const(p).call<area>();
+  }
+  CHECK( total == 36 + 40 );
+  Poly p{std::move(shapes[0])};
+  CHECK( p && ! shapes[0] && p.call<area>() == 36 );
+  shapes[1] = std::move(p);
+  CHECK( ! p && shapes[1].call<name>()[0] == 's' );
+}
+} // namespace vtable
+
+namespace dispatch
+{
+struct Ping { int seq; };
+struct Data { int bytes; };
+struct Quit {};
+
+int on_ping(Ping const& p) noexcept { return p.seq; }
+int on_data(Data& d) noexcept { return d.bytes *= 2; }
+int on_quit(Quit) noexcept { return -1; }
+int on_move(Data&& d) { Data t = static_cast<Data&&>(d); return t.bytes; }
+
+using Router = ltl::dispatch_table<&on_ping, &on_data, &on_quit>;
+using Mixed = ltl::dispatch_table<&on_ping, &on_move>;
+
+static_assert( Router::size == 3 );
+static_assert( Router::is_noexcept && ! Mixed::is_noexcept );
+SAME( Router::invoker, int(void*) noexcept );
+SAME( Mixed::invoker, int(void*) );
+static_assert( noexcept(Router::call(0, nullptr)) );
+static_assert( ! noexcept(Mixed::call(0, nullptr)) );
+
+void run()
+{
+  Ping p{7};
+  Data d{21};
+  Quit q;
+  void* msgs[] = {&p, &d, &q};
+  int sum = 0;
+  for (std::size_t i = 0; i != Router::size; ++i)
+    sum += Router::call(i, msgs[i]);
+  CHECK( sum == 7 + 42 - 1 && d.bytes == 42 );
+  CHECK( Mixed::call(1, &d) == 42 );
+}
+} // namespace dispatch
+
+namespace bus
+{
+struct Counter
+{
+  int n = 0;
+  int bump(int k) noexcept { return n += k; }
+  int peek(int k) const { return n + k; }
+  int last(int k) & noexcept { return n = k; }
+};
+int twice(int k) { return 2 * k; }
+int thrice(int k) noexcept { return 3 * k; }
+
+// Four handler types differing only in qualifiers and noexcept
+using Bus = ltl::bus<int(int), int(int) noexcept,
+                     int(int) const, int(int) & noexcept>;
+
+SAME( decltype(std::declval<Bus>().call<int(int)>(1)), int );
+static_assert( noexcept(std::declval<Bus>().call<int(int) noexcept>(1)) );
+static_assert( ! noexcept(std::declval<Bus>().call<int(int) const>(1)) );
+
+// binds<T> is true if on<&Counter::peek> takes an argument of type T
+template <class T, class = void> constexpr bool binds = false;
+template <class T> constexpr bool binds<T, std::void_t<decltype(
+  std::declval<Bus&>().on<&Counter::peek>(std::declval<T>()))>> = true;
+
+static_assert( binds<Counter&> && binds<Counter const&> );
+static_assert( ! binds<Counter> && ! binds<Counter const> );
+
+void run()
+{
+  Counter c;
+  Bus b;
+  CHECK( ! b.has<int(int)>() );
+  b.on<&twice>();
+  b.on<&Counter::peek>(c);
+  CHECK( b.has<int(int)>() && b.has<int(int) const>() );
+  CHECK( ! b.has<int(int) noexcept>() );
+  CHECK( b.call<int(int)>(5) == 10 );
+  b.on<&thrice>();
+  CHECK( b.call<int(int) noexcept>(5) == 15 );
+  b.on<&Counter::bump>(c);
+  CHECK( b.call<int(int) noexcept>(2) == 2 && c.n == 2 );
+  CHECK( b.call<int(int) const>(1) == 3 );
+  b.on<&Counter::last>(c);
+  CHECK( b.call<int(int) & noexcept>(9) == 9 && c.n == 9 );
+}
+} // namespace bus
+
+namespace memoize
+{
+int calls = 0;
+long cube(int x, short const& s) noexcept { ++calls; return long{x}*x*x + s; }
+
+std::atomic<int> lengths{0};
+std::size_t length(std::string const& s, double) { ++lengths; return s.size(); }
+
+// A reference result may refer into an earlier call's arguments
+static_assert( ! ltl::impl::memo_result<std::string const&>
+            && ! ltl::impl::memo_result<void>
+            && ltl::impl::memo_result<std::string> );
+
+// Throws copies the first Throws::fails copies of it then succeeds
+struct Throws
+{
+  static inline int fails = 0;
+  int v;
+  explicit Throws(int k) : v{k} {}
+  Throws(Throws const& t) : v{t.v} { if (fails && fails--) throw 0; }
+  bool operator==(Throws const& t) const { return v == t.v; }
+};
+} // namespace memoize
+namespace std
+{
+template <> struct hash<memoize::Throws>
+{
+  size_t operator()(memoize::Throws const& t) const noexcept
+  {
+    return size_t(t.v);
+  }
+};
+} // namespace std
+namespace memoize
+{
+int twice_calls = 0;
+int twice(Throws const& t) noexcept { ++twice_calls; return 2 * t.v; }
+
+using Packed = std::tuple<int, char, long*>;
+static_assert( ltl::impl::memo_hash<Packed>::packed );
+static_assert( ! ltl::impl::memo_hash<std::tuple<int, double>>::packed );
+static_assert( ! ltl::impl::memo_hash<std::tuple<std::string>>::packed );
+
+SAME( decltype(ltl::memoize<&cube>),
+      long(* const)(int, short const&) noexcept );
+
+void run()
+{
+  auto const f = ltl::memoize<&cube>;
+  CHECK( f(3, 1) == 28 && f(3, 1) == 28 && calls == 1 );
+  CHECK( f(3, 2) == 29 && calls == 2 );
+  CHECK( f(2, 0) == 8 && f(2, 0) == 8 && calls == 3 );
+
+  // LRU of 2 per thread: a b a c evicts b, the least recently used
+  auto const lru = ltl::memoize_lru<&cube, 2>;
+  SAME( decltype(lru), decltype(f) const );
+  calls = 0;
+  lru(1, 0), lru(2, 0), lru(1, 0), lru(3, 0);
+  CHECK( calls == 3 && lru(1, 0) == 1 && calls == 3 );
+  CHECK( lru(2, 0) == 8 && calls == 4 );
+
+  // Sharded, shared by threads; each key is computed at least once
+  auto const shared = ltl::memoize_sharded<&length, 64, 4>;
+  SAME( decltype(shared), std::size_t(* const)(std::string const&, double) );
+  std::vector<std::thread> threads;
+  for (int t = 0; t != 4; ++t)
+    threads.emplace_back([&] {
+      for (int i = 0; i != 200; ++i)
+        CHECK( shared(std::string(std::size_t(i % 10), 'x'), 0.5)
+               == std::size_t(i % 10) );
+    });
+  for (auto& t : threads)
+    t.join();
+  CHECK( lengths >= 10 && lengths < 200 );
+
+  // A key that can't be copied is not cached; f is called uncached
+  auto const last = ltl::memoize<&twice>;
+  Throws t{21};
+  Throws::fails = 1;
+  CHECK( last(t) == 42 && last(t) == 42 && twice_calls == 2 );
+  CHECK( last(t) == 42 && twice_calls == 2 );
+  auto const lru_twice = ltl::memoize_lru<&twice>;
+  Throws::fails = 1;
+  CHECK( lru_twice(t) == 42 && lru_twice(t) == 42 && twice_calls == 4 );
+  CHECK( lru_twice(t) == 42 && twice_calls == 4 );
+}
+} // namespace memoize
+
+namespace instrumented
+{
+// Probe counts the calls made within its scope while enabled
+struct Probe
+{
+  static inline bool on = false;
+  static inline int entered = 0, exited = 0;
+  static bool enabled() noexcept { return on; }
+  Probe() noexcept { ++entered; }
+  ~Probe() { ++exited; }
+};
+
+double mix(float f, int&& i) noexcept { return f + i; }
+struct Acc
+{
+  int n = 0;
+  int add(int k) volatile & { return n += k; }
+};
+
+using ltl::instrumented;
+SAME( decltype(instrumented<&mix, Probe>),
+      double(* const)(float, int&&) noexcept );
+SAME( decltype(instrumented<&Acc::add, Probe>),
+      int(* const)(Acc volatile&, int) );
+
+void run()
+{
+  auto const m = instrumented<&mix, Probe>;
+  CHECK( m(1.5f, 1) == 2.5 && Probe::entered == 0 );
+  Probe::on = true;
+  CHECK( m(0.5f, 2) == 2.5 && Probe::entered == 1 && Probe::exited == 1 );
+  Acc a;
+  CHECK( instrumented<&Acc::add, Probe>(a, 3) == 3 && Probe::exited == 2 );
+
+  // Default Tag latency_of<&f>: per-thread histograms merged on demand
+  using H = ltl::latency_histogram;
+  static_assert( H::bucket(15) == 15 && H::bucket(16) == 16 );
+  static_assert( H::bucket(33) == 32 && H::lower(32) == 32
+                                     && H::upper(32) == 33 );
+  static_assert( H::bucket(~0ull) == H::buckets - 1 );
+  static_assert( H::upper(H::buckets - 1) == ~0ull );
+  for (std::uint64_t ns = 1; ns < (1ull << 40); ns = ns * 3 + 1)
+    CHECK( H::lower(H::bucket(ns)) <= ns && ns <= H::upper(H::bucket(ns)) );
+
+  using Mix = ltl::latency_of<&mix>;
+  SAME( decltype(instrumented<&mix>), double(* const)(float, int&&) noexcept );
+  auto const timed = instrumented<&mix>;
+  timed(1.0f, 1);
+  CHECK( Mix::merge().total() == 0 );
+  Mix::enable();
+  timed(1.0f, 1);
+  std::thread([&] { timed(1.0f, 2); timed(1.0f, 3); }).join();
+  std::thread([&] { timed(1.0f, 4); }).join(); // reclaims a shard
+  H h = Mix::merge();
+  CHECK( h.total() == 4 && h.quantile(0.5) <= h.quantile(1.0) );
+  Mix::enable(false);
+  timed(1.0f, 1);
+  CHECK( Mix::merge().total() == 4 );
+
+  std::FILE* csv = std::tmpfile();
+  h.write_csv(csv);
+  std::rewind(csv);
+  char line[64] = {};
+  unsigned long long rows = 0, lo, hi, n, sum = 0;
+  CHECK( std::fgets(line, sizeof line, csv)
+      && std::strcmp(line, "lower_ns,upper_ns,count\n") == 0 );
+  while (std::fscanf(csv, "%llu,%llu,%llu", &lo, &hi, &n) == 3)
+    rows += lo <= hi, sum += n;
+  std::fclose(csv);
+  CHECK( rows != 0 && sum == 4 );
+  Mix::reset();
+  CHECK( Mix::merge().total() == 0 );
+}
+} // namespace instrumented
+
+namespace batching
+{
+struct Sink
+{
+  int* batches;
+  long* total;
+  void operator()(std::size_t n, int* ids, double* vals) noexcept
+  {
+    ++*batches;
+    for (std::size_t i = 0; i != n; ++i)
+      *total += ids[i] * static_cast<long>(vals[i]);
+  }
+};
+
+using Batch = ltl::batching<void(int, double const&) noexcept, Sink, 4>;
+static_assert( noexcept(std::declval<Batch&>()(1, 2.0)) );
+static_assert( std::is_invocable_r_v<void, Batch&, int, double const&> );
+
+void run()
+{
+  int batches = 0;
+  long total = 0;
+  {
+    Batch b{Sink{&batches, &total}};
+    for (int i = 1; i <= 10; ++i)
+      b(i, 2.0);
+    CHECK( batches == 2 && b.buffered() == 2 );
+    b.flush();
+    CHECK( batches == 3 && b.buffered() == 0 );
+    b(1, 1.0);
+  }
+  CHECK( batches == 4 && total == 2 * 55 + 1 );
+
+  // A throwing handler drops its batch and leaves the buffer empty
+  int thrown = 0;
+  auto fail_once = [&](std::size_t n, int*) {
+    if (thrown++ == 0)
+      throw std::runtime_error("batch");
+    total += long(n);
+  };
+  ltl::batching<void(int), decltype(fail_once), 2> t{fail_once};
+  t(1);
+  try { t(2); } catch (std::runtime_error const&) {}
+  CHECK( thrown == 1 && t.buffered() == 0 );
+  t(3);
+  t(4);
+  t(5);
+  t.flush();
+  CHECK( thrown == 3 && t.buffered() == 0 && total == 2 * 55 + 1 + 3 );
+}
+} // namespace batching
+
+namespace compose
+{
+// Move-only intermediate shows that stages move, not copy, results
+struct Buf
+{
+  int n;
+  explicit Buf(int k) noexcept : n{k} {}
+  Buf(Buf&&) = default;
+  Buf(Buf const&) = delete;
+  int size() const& noexcept { return n; }
+  int take() && noexcept { return n; }
+};
+
+Buf make(int k, int m) noexcept { return Buf{k * m}; }
+Buf grow(Buf b) noexcept { b.n += 1; return b; }
+long widen(int n) { return n * 10L; }
+
+using ltl::compose;
+SAME( decltype(compose<&make, &grow>), Buf(* const)(int, int) noexcept );
+SAME( decltype(compose<&make, &grow, &Buf::size>),
+      int(* const)(int, int) noexcept );
+SAME( decltype(compose<&make, &Buf::size, &widen>), long(* const)(int, int) );
+SAME( decltype(compose<&Buf::size, &widen>), long(* const)(Buf const&) );
+
+void run()
+{
+  CHECK( compose<&make, &grow, &grow, &Buf::size>(2, 3) == 8 );
+  CHECK( compose<&make, &Buf::size, &widen>(2, 3) == 60 );
+  CHECK( compose<&make, &grow, &Buf::take>(2, 3) == 7 );
+  Buf b{4};
+  CHECK( compose<&Buf::size, &widen>(b) == 40 );
+}
+} // namespace compose
+
+namespace packed
+{
+using F = void(char, double, char, long long);
+using Packed = ltl::packed_args<F>;
+
+struct Sorted { double d; long long l; char c0, c1; };
+static_assert( sizeof(Packed) == sizeof(Sorted) );
+static_assert( sizeof(Packed) < sizeof(std::tuple<char,double,char,long long>)
+            || alignof(double) == 1 );
+
+static_assert( Packed::slot(1) == 0 && Packed::slot(3) == 1 );
+static_assert( Packed::slot(0) == 2 && Packed::slot(2) == 3 );
+
+// Move-only parameter shows apply moves for && qualified function type
+struct Token
+{
+  int id;
+  explicit Token(int i) : id{i} {}
+  Token(Token&&) = default;
+};
+using Once = ltl::packed_args<int(Token, char const&) &&>;
+
+void run()
+{
+  Packed p{'a', 2.5, 'b', 7LL};
+  CHECK( p.get<0>() == 'a' && p.get<1>() == 2.5 );
+  CHECK( p.get<2>() == 'b' && p.get<3>() == 7 );
+  double sum = p.apply([](char a, double d, char b, long long l) {
+    return (b - a) + d + l;
+  });
+  CHECK( sum == 10.5 );
+
+  Once once{Token{4}, 'x'};
+  CHECK( once.apply([](Token t, char c) { return t.id + c; }) == 4 + 'x' );
+}
+} // namespace packed
+
+namespace bind_front
+{
+struct Empty {};
+struct Unit {};
+int scale(Empty, int k, int x) noexcept { return k * x; }
+int unit_scale(Empty, Unit, int k, int x) noexcept { return k * x; }
+long sum(long a, long b) { return a + b; }
+
+struct Acc
+{
+  int n = 0;
+  int add(int k) noexcept { return n += k; }
+  int get(int k) const { return n + k; }
+  int take() && noexcept { int t = n; n = 0; return t; }
+};
+void add_to(Acc& a, int& k) { a.n += k++; }
+
+using ltl::bind_front;
+using Scale0 = decltype(bind_front<&scale>());
+using Scale1 = decltype(bind_front<&scale>(Empty{}));
+using Scale2 = decltype(bind_front<&scale>(Empty{}, 3));
+using Sum1 = decltype(bind_front<&sum>(1L));
+
+// operator() is a non-template member of exactly the residual type
+SAME( decltype(&Scale1::operator()), int(Scale1::*)(int, int) const noexcept );
+SAME( decltype(&Scale2::operator()), int(Scale2::*)(int) const noexcept );
+SAME( decltype(&Sum1::operator()), long(Sum1::*)(long) const );
+
+// Empty bound values take no space
+static_assert( sizeof(Scale0) == 1 && sizeof(Scale1) == 1 );
+static_assert( sizeof(Scale2) == sizeof(int) );
+static_assert( sizeof(decltype(bind_front<&unit_scale>(Empty{}, Unit{}, 3)))
+               == sizeof(int) );
+static_assert( sizeof(Sum1) == sizeof(long) );
+
+using AddRef = decltype(bind_front<&Acc::add>(std::ref(std::declval<Acc&>())));
+using AddVal = decltype(bind_front<&Acc::add>(Acc{}));
+using Get = decltype(bind_front<&Acc::get>(Acc{}));
+using Take = decltype(bind_front<&Acc::take>(Acc{}));
+SAME( decltype(&AddRef::operator()), int(AddRef::*)(int) const noexcept );
+SAME( decltype(&AddVal::operator()), int(AddVal::*)(int) & noexcept );
+SAME( decltype(&Get::operator()), int(Get::*)(int) const );
+SAME( decltype(&Take::operator()), int(Take::*)() && noexcept );
+static_assert( sizeof(AddRef) == sizeof(Acc*) );
+
+void run()
+{
+  auto triple = bind_front<&scale>(Empty{}, 3);
+  CHECK( triple(5) == 15 );
+  CHECK( bind_front<&unit_scale>(Empty{}, Unit{}, 3)(5) == 15 );
+  auto copy = triple;
+  CHECK( copy(2) == 6 );
+  CHECK( bind_front<&sum>(1L, 2L)() == 3 );
+
+  Acc acc;
+  auto add = bind_front<&Acc::add>(std::ref(acc));
+  add(2);
+  add(3);
+  CHECK( acc.n == 5 );
+  auto get = bind_front<&Acc::get>(acc);
+  CHECK( get(1) == 6 );
+  CHECK( bind_front<&Acc::take>(acc)() == 5 && acc.n == 5 );
+
+  // A reference_wrapper bound beside a & parameter is a non-const lvalue
+  int k = 2;
+  auto addk = bind_front<&add_to>(std::ref(acc), k);
+  addk();
+  addk();
+  CHECK( acc.n == 5 + 2 + 3 && k == 2 );
+}
+} // namespace bind_front
+
+namespace inline_function
+{
+using Task = ltl::inline_function<void() noexcept>;
+using Calc = ltl::inline_function<int(int), 2 * sizeof(void*)>;
+
+static_assert( noexcept(std::declval<Task&>()()) );
+static_assert( ! noexcept(std::declval<Calc&>()(1)) );
+static_assert( std::is_nothrow_move_constructible_v<Task> );
+static_assert( ! std::is_copy_constructible_v<Task> );
+
+// Only a noexcept callable converts to a noexcept signature
+static_assert( std::is_constructible_v<Task, void(*)() noexcept> );
+static_assert( std::is_constructible_v<Calc, int(*)(int) noexcept> );
+static_assert( std::is_constructible_v<Calc, int(*)(int)> );
+static_assert( ! std::is_constructible_v<Task, void(*)()> );
+static_assert( ! std::is_constructible_v<Task, int> );
+
+// Only a callable that fits, and moves nothrow, is stored
+struct Big { char bytes[64]; void operator()() noexcept {} };
+struct ThrowingMove
+{
+  ThrowingMove() = default;
+  ThrowingMove(ThrowingMove&&) noexcept(false) {}
+  void operator()() noexcept {}
+};
+static_assert( ! std::is_convertible_v<Big, Task> );
+static_assert( ! std::is_constructible_v<Task, ThrowingMove> );
+static_assert( std::is_constructible_v<
+                 ltl::inline_function<void() noexcept, 64>, Big> );
+
+int live = 0;
+struct Tracked
+{
+  int* hits;
+  Tracked(int* h) noexcept : hits{h} { ++live; }
+  Tracked(Tracked&& o) noexcept : hits{o.hits} { ++live; }
+  ~Tracked() { --live; }
+  void operator()() noexcept { ++*hits; }
+};
+
+void run()
+{
+  int hits = 0;
+  {
+    Task t{Tracked{&hits}};
+    CHECK( live == 1 && t );
+    t();
+    Task u{std::move(t)};
+    CHECK( live == 1 && !t && u );
+    u();
+    t = std::move(u);
+    t();
+    Task v{Tracked{&hits}};
+    CHECK( live == 2 );
+    t = std::move(v);
+    CHECK( live == 1 && t && !v );
+    t();
+  }
+  CHECK( hits == 4 && live == 0 );
+
+  int base = 10;
+  Calc c{[&base](int x) { return base + x; }};
+  CHECK( c(5) == 15 );
+}
+} // namespace inline_function
+
+namespace nothrow
+{
+int parse(char const* s)
+{
+  if (*s < '0' || *s > '9')
+    throw std::invalid_argument(s);
+  return *s - '0';
+}
+int twice(int x) noexcept { return 2 * x; }
+void fail() { throw 1; }
+
+std::optional<int> none() noexcept { return {}; }
+
+// error codes mapped from the in-flight exception
+int code() noexcept
+{
+  try { throw; }
+  catch (std::invalid_argument const&) { return 22; }
+  catch (...) { return -1; }
+}
+
+struct Meter
+{
+  int n = 0;
+  int read(int k) & { if (k < 0) throw 0; return n += k; }
+};
+
+constexpr auto safe_parse = ltl::nothrow<&parse, &none>;
+SAME( decltype(safe_parse),
+      std::optional<int>(* const)(char const*) noexcept );
+SAME( decltype(ltl::nothrow<&Meter::read, &code>),
+      int(* const)(Meter&, int) noexcept );
+
+static_assert( ltl::impl::nothrow<&twice, &none>::pass_through );
+static_assert( ! ltl::impl::nothrow<&parse, &none>::pass_through );
+
+void run()
+{
+  CHECK( safe_parse("7") == 7 );
+  CHECK( ! safe_parse("x") );
+  CHECK( ltl::nothrow<&twice, &none>(4) == 8 );
+  CHECK( ltl::nothrow<&parse, &code>("?") == 22 );
+  CHECK( ltl::nothrow<&fail, &code>() == -1 );
+
+  Meter m;
+  CHECK( ltl::nothrow<&Meter::read, &code>(m, 3) == 3 );
+  CHECK( ltl::nothrow<&Meter::read, &code>(m, -1) == -1 && m.n == 3 );
+}
+} // namespace nothrow
+
+namespace convert
+{
+// A callback registry slot type and candidate handlers
+using Callback = void(int);
+
+int ticks = 0;
+void on_tick(int n) noexcept { ticks += n; }
+long on_count(long n) { return ticks += int(n); }
+
+struct Gauge
+{
+  int v = 0;
+  int get() const noexcept { return v; }
+  void set(int x) { v = x; }
+};
+
+// Dropping noexcept needs no thunk; the pointer is the function itself
+static_assert( ltl::function_convert<Callback, &on_tick> == &on_tick );
+SAME( decltype(ltl::function_convert<Callback, &on_count>),
+      void(* const)(int) );
+
+// Member pointers convert likewise, else a thunk of the free form
+SAME( decltype(ltl::function_convert<int() const, &Gauge::get>),
+      int (Gauge::* const)() const );
+SAME( decltype(ltl::function_convert<int(Gauge&), &Gauge::get>),
+      int(* const)(Gauge&) );
+SAME( decltype(ltl::function_convert<void(Gauge&, int), &Gauge::set>),
+      void(* const)(Gauge&, int) );
+
+void run()
+{
+  Callback* registry[] = { ltl::function_convert<Callback, &on_tick>,
+                           ltl::function_convert<Callback, &on_count> };
+  for (auto cb : registry)
+    cb(2);
+  CHECK( ticks == 4 );
+
+  Gauge g;
+  ltl::function_convert<void(Gauge&, int), &Gauge::set>(g, 5);
+  CHECK( ltl::function_convert<int(Gauge&), &Gauge::get>(g) == 5 );
+  auto get = ltl::function_convert<int() const, &Gauge::get>;
+  CHECK( get == &Gauge::get && (g.*get)() == 5 );
+}
+} // namespace convert
+
+namespace optimal
+{
+struct Vec { double x, y; };
+struct Name { std::string s; };
+
+double dot(Vec const& a, Vec const& b) noexcept
+{
+  return a.x * b.x + a.y * b.y;
+}
+std::size_t length(Name n) { return n.s.size(); }
+
+struct Scale
+{
+  double k;
+  Vec apply(Vec const& v) const { return {k * v.x, k * v.y}; }
+};
+
+SAME( decltype(ltl::optimal_params<&dot>),
+      double(* const)(Vec, Vec) noexcept );
+SAME( decltype(ltl::optimal_params<&length>),
+      std::size_t(* const)(Name const&) );
+SAME( decltype(ltl::optimal_params<&Scale::apply>),
+      Vec(* const)(Scale const&, Vec) );
+
+void run()
+{
+  CHECK( ltl::optimal_params<&dot>({1, 2}, {3, 4}) == 11 );
+  CHECK( ltl::optimal_params<&length>(Name{"four"}) == 4 );
+  Scale s{2};
+  CHECK( ltl::optimal_params<&Scale::apply>(s, {1, 3}).y == 6 );
+}
+} // namespace optimal
+
+namespace simd_map
+{
+float fma(float a, float b, int c) noexcept { return a * b + float(c); }
+
+SAME( decltype(ltl::simd_map<&fma>),
+      void(* const)(std::size_t, float*, float const*, float const*,
+                    int const*) noexcept );
+
+void run()
+{
+  float a[11], b[11], out[11];
+  int c[11];
+  for (int i = 0; i != 11; ++i)
+    a[i] = float(i), b[i] = 2, c[i] = -i;
+
+  ltl::simd_map<&fma, 4>(11, out, a, b, c);
+  bool ok = true;
+  for (int i = 0; i != 11; ++i)
+    ok = ok && out[i] == float(i);
+  CHECK( ok );
+
+  // the ISA's own lane count, for every tail length
+  std::vector<float> x(100), y(100, 2), z(100, -1);
+  std::vector<int> w(100);
+  for (int i = 0; i != 100; ++i)
+    x[i] = float(i), w[i] = -i;
+  for (std::size_t n = 0; n != 40; ++n) {
+    ltl::simd_map<&fma>(n, z.data(), x.data(), y.data(), w.data());
+    for (std::size_t i = 0; i != 40; ++i)
+      ok = ok && z[i] == (i < n ? float(i) : -1.f);
+    std::fill(z.begin(), z.end(), -1.f);
+  }
+  CHECK( ok );
+  CHECK( std::strlen(ltl::simd_isa()) != 0 );
+}
+} // namespace simd_map
+
+namespace parallel
+{
+void bump(int& x) noexcept { x += 1; }
+long square(int x) noexcept { return long(x) * x; }
+std::size_t take(std::string&& s) noexcept { auto t = std::move(s);
+                                             return t.size(); }
+// nested(v) a parallel_apply from within parallel_apply's tasks
+void nested(std::vector<int>& v) noexcept { ltl::parallel_apply<&bump>(v); }
+
+void run()
+{
+  std::vector<int> v(10000);
+  ltl::parallel_apply<&bump>(v);
+  ltl::parallel_apply<&bump>(v);
+
+  std::vector<long> sq(v.size());
+  for (int i = 0; i != int(v.size()); ++i)
+    v[i] += i;
+  ltl::parallel_apply<&square>(v, sq);
+  bool ok = true;
+  for (int i = 0; i != int(v.size()); ++i)
+    ok = ok && sq[i] == long(i + 2) * (i + 2);
+  CHECK( ok );
+
+  std::string s[3] = {"moved strings are left", "b", "c"};
+  std::size_t n[3];
+  ltl::parallel_apply<&take>(s, n);
+  CHECK( n[0] == 22 && n[2] == 1 && s[0].empty() );
+
+  // output starting part way into a cache line; chunks split at lines
+  struct Span {
+    long* p; std::size_t n;
+    long* data() const { return p; }
+    std::size_t size() const { return n; }
+  };
+  for (std::size_t skew = 0; skew != 9; ++skew) {
+    std::vector<long> out(v.size() + 9, -1);
+    ltl::parallel_apply<&square>(v, Span{out.data() + skew, v.size()});
+    ok = out[skew + v.size()] == -1 && (skew == 0 || out[skew - 1] == -1);
+    for (int i = 0; i != int(v.size()); ++i)
+      ok = ok && out[skew + i] == long(i + 2) * (i + 2);
+    CHECK( ok );
+  }
+
+  ltl::executor ex{2};
+  std::vector<int> w(10000, 0);
+  ltl::parallel_apply<&bump>(ex, w);
+  ltl::parallel_apply<&square>(ex, w, sq);
+  ok = w[0] == 1 && w[9999] == 1 && sq[0] == 1 && sq[9999] == 1;
+  CHECK( ok );
+
+  std::vector<std::vector<int>> vv(200, std::vector<int>(5000, 1));
+  ltl::parallel_apply<&nested>(vv);
+  for (auto const& w : vv)
+    for (int x : w)
+      ok = ok && x == 2;
+  CHECK( ok );
+}
+} // namespace parallel
+
+namespace invoke
+{
+struct Box
+{
+  int v = 1;
+  int get() const noexcept { return v; }
+  int& ref() & { return v; }
+  int take() && { int t = v; v = 0; return t; }
+  int drain() && noexcept { int t = v; v = 0; return t; }
+};
+constexpr int twice(int x) noexcept { return 2 * x; }
+
+static_assert( noexcept(ltl::invoke(twice, 1)) );
+static_assert( noexcept(ltl::invoke(&Box::get, std::declval<Box&>())) );
+static_assert( ! noexcept(ltl::invoke(&Box::ref, std::declval<Box&>())) );
+static_assert( noexcept(ltl::invoke(&Box::drain, std::declval<Box*>())) );
+static_assert( ! noexcept(ltl::invoke(&Box::take, std::declval<Box*>())) );
+SAME( decltype(ltl::invoke(&Box::v, std::declval<Box&>())), int& );
+SAME( decltype(ltl::invoke(&Box::v, std::declval<Box>())), int&& );
+SAME( decltype(ltl::invoke(&Box::ref, std::declval<Box&>())), int& );
+static_assert( ltl::invoke(twice, 3) == 6 );
+
+void run()
+{
+  Box b;
+  Box const& cb = b;
+  CHECK( ltl::invoke(&Box::get, cb) == 1 );
+  ltl::invoke(&Box::ref, &b) = 4;
+  CHECK( ltl::invoke(&Box::v, std::ref(b)) == 4 );
+  CHECK( ltl::invoke(&Box::get, std::cref(b)) == 4 );
+  CHECK( ltl::invoke(&Box::take, Box{}) == 1 );
+  CHECK( ltl::invoke(&Box::take, &b) == 4 && b.v == 0 );
+  b.v = 5;
+  CHECK( ltl::invoke(&Box::drain, &b) == 5 && b.v == 0 );
+  CHECK( ltl::invoke([](int x) { return x + 1; }, 1) == 2 );
+  CHECK( ltl::invoke_r<long>(twice, 2) == 4L );
+  ltl::invoke_r<void>(&Box::ref, b);
+}
+} // namespace invoke
+
+namespace varargs
+{
+int sum(int n, ...);
+int vsum(int n, std::va_list args) noexcept
+{
+  int s = 0;
+  while (n--)
+    s += va_arg(args, int);
+  return s;
+}
+
+struct Log
+{
+  mutable char buf[32];
+  int log(char const* fmt, ...) const&; // declared only, for its type
+  int vlog(char const* fmt, std::va_list args) const&
+  {
+    return std::vsnprintf(buf, sizeof buf, fmt, args);
+  }
+};
+
+SAME( ltl::function_valist_t<decltype(sum)>, int(int, std::va_list) );
+
+constexpr auto fsum = ltl::variadic_forwarder<&sum, &vsum>;
+constexpr auto flog = ltl::variadic_forwarder<&Log::log, &Log::vlog>;
+SAME( decltype(fsum), int(* const)(int, ...) );
+SAME( decltype(flog), int(* const)(Log const&, char const*, ...) );
+
+// The parameter before ... must be of a type unchanged by promotion
+enum Color { red };
+enum class Scoped : char { on };
+static_assert( ltl::impl::is_promoted<float> && ltl::impl::is_promoted<bool> );
+static_assert( ltl::impl::is_promoted<char> && ltl::impl::is_promoted<short> );
+static_assert( ltl::impl::is_promoted<unsigned char>
+            && ltl::impl::is_promoted<char16_t>
+            && ltl::impl::is_promoted<Color> );
+static_assert( ! ltl::impl::is_promoted<int> && ! ltl::impl::is_promoted<long>
+            && ! ltl::impl::is_promoted<double>
+            && ! ltl::impl::is_promoted<unsigned>
+            && ! ltl::impl::is_promoted<char const*>
+            && ! ltl::impl::is_promoted<Scoped> );
+
+void run()
+{
+  CHECK( fsum(3, 1, 2, 3) == 6 && fsum(0) == 0 );
+  Log l;
+  CHECK( flog(l, "%d-%s", 42, "ok") == 5
+         && std::string(l.buf) == "42-ok" );
+}
+} // namespace varargs
+
+namespace record
+{
+using Tick = void(int, double const&, char);
+using Other = void(int, float, char);
+
+static_assert( ltl::impl::layout_hash<Tick>
+            != ltl::impl::layout_hash<Other> );
+static_assert( ltl::impl::layout_hash<Tick>
+            == ltl::impl::layout_hash<void(int, double, char)> );
+static_assert( std::is_trivially_copyable_v<ltl::call_record<Tick>> );
+
+void run()
+{
+  std::FILE* log = std::tmpfile();
+  if (!log)
+    return;
+  ltl::call_recorder<Tick, 2>::write_header(log);
+  {
+    ltl::call_recorder<Tick, 2> rec{log};
+    for (int i = 0; i != 5; ++i)
+      rec(i, i * 0.5, char('a' + i));
+  }
+
+  std::rewind(log);
+  ltl::call_replayer<Other> wrong{log};
+  CHECK( ! wrong );
+
+  std::rewind(log);
+  ltl::call_replayer<Tick> replay{log};
+  int sum = 0;
+  double half = 0;
+  std::string chars;
+  auto calls = replay.replay([&](int i, double const& d, char c) {
+    sum += i; half += d; chars += c;
+  }, true);
+  CHECK( replay && calls == 5 );
+  CHECK( sum == 10 && half == 5 && chars == "abcde" );
+  std::fclose(log);
+
+  // Two recorders on one stream, as for two threads, share its header
+  log = std::tmpfile();
+  if (!log)
+    return;
+  ltl::call_recorder<Tick>::write_header(log);
+  {
+    ltl::call_recorder<Tick> a{log}, b{log};
+    a(1, 0.5, 'a');
+    b(2, 1.0, 'b');
+    a(3, 1.5, 'c');
+    b(4, 2.0, 'd');
+  }
+  std::rewind(log);
+  ltl::call_replayer<Tick> both{log};
+  sum = 0;
+  chars.clear();
+  calls = both.replay([&](int i, double const&, char c) {
+    sum += i; chars += c;
+  });
+  CHECK( both && calls == 4 && sum == 10 );
+  CHECK( chars == "bdac" || chars == "acbd" );
+  std::fclose(log);
+
+  // Reference parameters replay as lvalues, && parameters as xvalues
+  log = std::tmpfile();
+  if (!log)
+    return;
+  using Ref = void(int&, double);
+  using Rval = void(int&&);
+  ltl::call_recorder<Ref>::write_header(log);
+  {
+    ltl::call_recorder<Ref> rec{log};
+    int i = 7;
+    rec(i, 0.5);
+  }
+  std::rewind(log);
+  ltl::call_replayer<Ref> refs{log};
+  sum = 0;
+  calls = refs.replay([&](int& i, double d) { sum += i + int(d * 2); });
+  CHECK( refs && calls == 1 && sum == 8 );
+  std::fclose(log);
+
+  log = std::tmpfile();
+  if (!log)
+    return;
+  ltl::call_recorder<Rval>::write_header(log);
+  {
+    ltl::call_recorder<Rval> rec{log};
+    rec(3);
+    rec(4);
+  }
+  std::rewind(log);
+  ltl::call_replayer<Rval> rvals{log};
+  sum = 0;
+  calls = rvals.replay([&](int&& i) { sum += i; });
+  CHECK( rvals && calls == 2 && sum == 7 );
+  std::fclose(log);
+}
+} // namespace record
+
+namespace call_site
+{
+struct Add { int k; int operator()(int x) const noexcept { return x + k; } };
+struct Mul { int k; int operator()(int x) const noexcept { return x * k; } };
+struct Neg { int operator()(int x) const noexcept { return -x; } };
+
+using Site = ltl::cached_call_site<int(int) noexcept, Add, Mul>;
+
+static_assert( noexcept(std::declval<Site&>()(1)) );
+static_assert( ! std::is_copy_constructible_v<Site> );
+static_assert( std::is_constructible_v<Site, Neg> );
+
+void run()
+{
+  ltl::inline_function<int(int)> f{Add{1}};
+  CHECK( f.target<Add>() && f.target<Add>()->k == 1 && ! f.target<Mul>() );
+
+  std::vector<Site> sites;
+  sites.emplace_back(Add{1});
+  sites.emplace_back(Mul{3});
+  sites.emplace_back(Neg{});
+  int sum = 0;
+  for (int i = 0; i != 2; ++i)
+    for (auto& site : sites)
+      sum += site(5);
+  CHECK( sum == 2 * (6 + 15 - 5) );
+  CHECK( sites[0].hits(0) == 2 && sites[0].hits(1) == 0 );
+  CHECK( sites[1].hits(1) == 2 && sites[1].misses() == 0 );
+  CHECK( sites[2].hits() == 0 && sites[2].misses() == 2 );
+
+  Site moved{std::move(sites[1])};
+  CHECK( moved(2) == 6 && moved.hits(1) == 3 );
+  moved.reset_counts();
+  CHECK( moved.hits() == 0 && ! Site{} );
+}
+} // namespace call_site
+
+namespace hot_slot
+{
+int one(int x) noexcept { return x + 1; }
+int two(int x) noexcept { return x + 2; }
+int may_throw(int x) { return x; }
+
+using Slot = ltl::hot_slot<int(int) const noexcept>;
+
+SAME( Slot::pointer, int(*)(int) noexcept );
+SAME( ltl::hot_slot<int(int) &&>::pointer, int(*)(int) );
+static_assert( noexcept(std::declval<Slot&>()(1)) );
+static_assert( std::is_constructible_v<ltl::hot_slot<int(int)>,
+                                       decltype(&one)> );
+static_assert( ! std::is_constructible_v<Slot, decltype(&may_throw)> );
+
+// use<I> an implementation that reads table I, which is reclaimed
+// (poisoned with zeros, as if freed) while swapped out of a slot
+int tables[2][4] = {{1, 1, 1, 1}, {1, 1, 1, 1}};
+template <int I> int use(int x) noexcept { return tables[I][x & 3]; }
+
+void run()
+{
+  Slot slot{one};
+  CHECK( slot(1) == 2 && slot.load() == one );
+  CHECK( slot.swap(two) == one && slot(1) == 3 );
+
+  ltl::hot_slot<int(int) noexcept, true> live{use<0>};
+  std::atomic<bool> stop{false};
+  std::atomic<int> bad{0};
+  std::vector<std::thread> callers;
+  for (int t = 0; t != 4; ++t)
+    callers.emplace_back([&] {
+      for (int i = 0; !stop; ++i)
+        if (live(i) != 1)
+          ++bad;
+    });
+  for (int n = 1; n != 200; ++n) {
+    int* old = tables[(n - 1) & 1];
+    live.swap(n & 1 ? use<1> : use<0>);
+    live.synchronize();
+    std::fill(old, old + 4, 0);
+    std::this_thread::yield();
+    std::fill(old, old + 4, 1);
+  }
+  stop = true;
+  for (auto& c : callers)
+    c.join();
+  CHECK( bad == 0 );
+}
+} // namespace hot_slot
+
+namespace executor
+{
+struct Account
+{
+  std::atomic<long> total{0};
+  void add(long k) noexcept { total += k; }
+  long get() const { return total; }
+  long peek() const noexcept { return total; }
+  std::atomic<long>& ref() noexcept { return total; }
+};
+
+void fail() { throw std::runtime_error("task"); }
+
+// sum(ex, lo, hi, out) forks halves down to single leaves, joining each
+// fork by a counter, and adds lo + ... + (hi - 1) to out
+void sum(ltl::executor& ex, long lo, long hi, std::atomic<long>& out) noexcept
+{
+  if (hi - lo == 1) {
+    out += lo;
+    return;
+  }
+  long mid = lo + (hi - lo) / 2;
+  std::atomic<int> forks{1};
+  ex.submit([&, mid, hi]() noexcept { sum(ex, mid, hi, out); --forks; });
+  sum(ex, lo, mid, out);
+  ex.wait_until([&] { return forks.load() == 0; });
+}
+
+void run()
+{
+  ltl::executor ex{3};
+  CHECK( ex.size() == 3 );
+
+  Account acc;
+  SAME( decltype(ex.submit(&Account::add, &acc, 1L)), void );
+  SAME( decltype(ex.submit(&Account::get, std::ref(acc))),
+        std::future<long> );
+  SAME( decltype(ex.submit(fail)), std::future<void> );
+  SAME( decltype(ex.submit(&Account::peek, &acc)),
+        ltl::executor::result<long> );
+  SAME( decltype(ex.submit(&Account::ref, &acc).get()), std::atomic<long>& );
+
+  for (long k = 1; k <= 100; ++k)
+    ex.submit(&Account::add, &acc, k);
+  ex.wait();
+  CHECK( acc.total == 5050 );
+  CHECK( ex.submit(&Account::get, std::ref(acc)).get() == 5050 );
+  CHECK( ex.submit(&Account::peek, &acc).get() == 5050 );
+  CHECK( &ex.submit(&Account::ref, &acc).get() == &acc.total );
+  {
+    auto peeked = ex.submit(&Account::peek, &acc);
+    peeked.wait();
+    CHECK( peeked.is_ready() && peeked.get() == 5050 );
+  }
+
+  auto failed = ex.submit(fail);
+  bool thrown = false;
+  try { failed.get(); } catch (std::runtime_error const&) { thrown = true; }
+  CHECK( thrown );
+
+  std::atomic<long> out{0};
+  ex.submit([&]() noexcept { sum(ex, 0, 1000, out); });
+  ex.wait();
+  CHECK( out == 999 * 1000 / 2 );
+}
+} // namespace executor
+
+int main()
+{
+  c_thunk::run();
+  vtable::run();
+  dispatch::run();
+  bus::run();
+  memoize::run();
+  instrumented::run();
+  batching::run();
+  compose::run();
+  packed::run();
+  bind_front::run();
+  inline_function::run();
+  nothrow::run();
+  convert::run();
+  optimal::run();
+  simd_map::run();
+  parallel::run();
+  invoke::run();
+  varargs::run();
+  record::run();
+  call_site::run();
+  hot_slot::run();
+  executor::run();
+  return fails;
+}
@@ -497,6 +497,59 @@ static_assert(
                    ltl::arg_types<char,bool(*)()> >
 );
 
+static_assert(
+    ltl::function_is_call_compatible_v< void(int), void(int) >
+ && ltl::function_is_call_compatible_v< void(int) noexcept, void(int) >
+ && ltl::function_is_call_compatible_v< int() const& noexcept, int() const&>
+ &&!ltl::function_is_call_compatible_v< void(int), void(int) noexcept >
+ &&!ltl::function_is_call_compatible_v< int() const, int() >
+ &&!ltl::function_is_call_compatible_v< void(int), void(long) >
+ && ltl::function_is_call_compatible< void(...) noexcept, void(...) >()
+);
+
+struct Big { char c[64]; };
+struct Str { Str(Str const&); };            // not trivially copyable
+struct Own { Own(Own&&); };                 // move-only
+
+static_assert(
+   std::is_same_v< ltl::function_optimal_params_t<
+        int(long const&, Big, Big const&, Str, int&, char&&) const&>,
+                   int(long, Big const&, Big const&, Str const&,
+                       int&, char&&) const& >
+&& std::is_same_v< ltl::function_optimal_params_t<
+        void(double const&, Own, ...) noexcept>,
+                   void(double, Own, ...) noexcept >
+&& std::is_same_v< ltl::function_optimal_params_t<void(Big const&), 64>,
+                   void(Big) >
+);
+
+static_assert(
+   std::is_same_v< ltl::function_valist_t<int(char const*, ...) const&>,
+                   int(char const*, std::va_list) const& >
+&& std::is_same_v< ltl::function_valist_t<void(...) noexcept>,
+                   void(std::va_list) noexcept >
+);
+
+// Qualifier flag words round trip through function_set_qualifiers_t
+template <typename F>
+constexpr bool qualifiers_round_trip = std::is_same_v<F,
+   ltl::function_set_qualifiers_t<ltl::function_signature_t<F>,
+                                  ltl::function_qualifiers_v<F>>>;
+
+static_assert(
+    ltl::function_qualifiers_v<void()> == 0
+ && ltl::function_qualifiers_v<void() const & noexcept>
+    == (ltl::const_qual_v | ltl::lval_ref_qual_v | ltl::noexcept_qual_v)
+ && ltl::function_qualifiers_v<void(...) volatile &&>
+    == (ltl::volatile_qual_v | ltl::rval_ref_qual_v)
+ && qualifiers_round_trip<int(char) const volatile && noexcept>
+ && qualifiers_round_trip<int(char, ...) &>
+ && qualifiers_round_trip<void() volatile noexcept>
+ && std::is_same_v<ltl::function_set_qualifiers_t<void(int) const,
+                                                  ltl::noexcept_qual_v>,
+                   void(int) noexcept>
+);
+
 int main()
 {
     return 0;